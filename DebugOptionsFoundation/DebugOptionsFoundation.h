@@ -20,3 +20,7 @@ FOUNDATION_EXPORT const unsigned char DebugOptionsFoundationVersionString[];
 #import <DebugOptionsFoundation/PWDebugOptionGroup.h>
 #import <DebugOptionsFoundation/PWDebugOptions.h>
 #import <DebugOptionsFoundation/PWDebugOptionMacros.h>
+#import <DebugOptionsFoundation/PWDebugOptionSearchIndex.h>
+#import <DebugOptionsFoundation/PWDebugOptionStore.h>
+#import <DebugOptionsFoundation/PWDebugOptionFileStore.h>
+#import <DebugOptionsFoundation/PWDebugTimerWheel.h>
@@ -0,0 +1,44 @@
+//
+//  PWDebugLock.h
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <Foundation/Foundation.h>
+
+// Short non-recursive lock for the internal state of the library: os_unfair_lock on Apple platforms, a pthread mutex
+// elsewhere. Initialize statics with PW_DEBUG_LOCK_INIT, instance variables with PWDebugLockInit, and pair the latter
+// with PWDebugLockDestroy.
+
+#ifdef __APPLE__
+
+#import <os/lock.h>
+
+typedef os_unfair_lock PWDebugLock;
+
+#define PW_DEBUG_LOCK_INIT OS_UNFAIR_LOCK_INIT
+
+NS_INLINE void PWDebugLockInit (PWDebugLock* lock)      { *lock = OS_UNFAIR_LOCK_INIT; }
+NS_INLINE void PWDebugLockDestroy (PWDebugLock* lock)   { (void)lock; }
+NS_INLINE void PWDebugLockLock (PWDebugLock* lock)      { os_unfair_lock_lock (lock); }
+NS_INLINE void PWDebugLockUnlock (PWDebugLock* lock)    { os_unfair_lock_unlock (lock); }
+
+#else
+
+#import <pthread.h>
+
+typedef pthread_mutex_t PWDebugLock;
+
+#define PW_DEBUG_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+
+NS_INLINE void PWDebugLockInit (PWDebugLock* lock)      { pthread_mutex_init (lock, NULL); }
+NS_INLINE void PWDebugLockDestroy (PWDebugLock* lock)   { pthread_mutex_destroy (lock); }
+NS_INLINE void PWDebugLockLock (PWDebugLock* lock)      { pthread_mutex_lock (lock); }
+NS_INLINE void PWDebugLockUnlock (PWDebugLock* lock)    { pthread_mutex_unlock (lock); }
+
+#endif
@@ -0,0 +1,50 @@
+//
+//  PWDebugOptionFileStore.h
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <Foundation/Foundation.h>
+#import <DebugOptionsFoundation/PWDebugOptionStore.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Append-only file store for headless processes and Linux, where user defaults are slow to set up, differ per user or
+/// are not available.
+///
+/// Every change appends one checksummed record to the file. A crash can at most tear the record being written, which
+/// is detected and dropped by the next load. Opening the store maps the file and reads it sequentially once, all
+/// reads are served from memory afterwards. Once most records are superseded, the file is compacted: the live values
+/// are written to a new file, which atomically replaces the old one.
+///
+/// Thread safe, but a file must not be used by more than one process at a time.
+@interface PWDebugOptionFileStore : NSObject <PWDebugOptionStore>
+
+/// The store for 'path', creating the file if it does not exist. There is one store per path in a process.
+/// Returns nil if the file can’t be opened or is not a store file.
++ (nullable PWDebugOptionFileStore*) storeWithPath:(NSString*)path error:(NSError**)error;
+
+- (instancetype) init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly, copy)   NSString*           path;
+
+/// Number of records in the file, including superseded ones.
+@property (nonatomic, readonly)         NSUInteger          recordCount;
+
+/// Number of keys with a value.
+@property (nonatomic, readonly)         NSUInteger          count;
+
+/// Rewrite the file with the live values only. Happens automatically when most records are superseded.
+- (BOOL) compact:(NSError**)error;
+
+/// A store in the same directory, named after the suite.
+- (id<PWDebugOptionStore>) storeForSuiteName:(NSString*)suiteName;
+
+@end
+
+NS_ASSUME_NONNULL_END
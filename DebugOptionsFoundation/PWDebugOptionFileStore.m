@@ -0,0 +1,456 @@
+//
+//  PWDebugOptionFileStore.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import "PWDebugOptionFileStore.h"
+#import "PWDebugLock.h"
+#import <errno.h>
+#import <fcntl.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <unistd.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// File layout, all integers little endian:
+//
+//  header:     uint32 magic, uint32 version
+//  record:     uint32 payload length, uint32 CRC-32 of payload, payload
+//  payload:    uint8 type, uint16 key length, UTF-8 key, value
+//  value:      int64 for PWRecordTypeInteger, IEEE double bits as uint64 for PWRecordTypeDouble,
+//              uint32 length and UTF-8 bytes for PWRecordTypeString, nothing for PWRecordTypeRemove
+
+static const uint32_t PWFileStoreMagic   = 0x4F445750;  // "PWDO"
+static const uint32_t PWFileStoreVersion = 1;
+static const size_t   PWHeaderSize       = 8;
+static const size_t   PWRecordHeaderSize = 8;
+
+typedef NS_ENUM (uint8_t, PWRecordType) {
+    PWRecordTypeRemove  = 0,
+    PWRecordTypeInteger = 1,
+    PWRecordTypeDouble  = 2,
+    PWRecordTypeString  = 3,
+};
+
+// Compact when the file holds this many times more records than live values, but not for tiny files.
+static const NSUInteger PWCompactionRatio       = 4;
+static const NSUInteger PWCompactionMinRecords  = 64;
+
+static uint32_t PWCRC32 (const uint8_t* bytes, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static void PWAppendInteger (NSMutableData* data, uint64_t value, size_t size)
+{
+    uint8_t bytes[8];
+    for (size_t i = 0; i < size; ++i)
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    [data appendBytes:bytes length:size];
+}
+
+static uint64_t PWReadInteger (const uint8_t* bytes, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i)
+        value |= (uint64_t)bytes[i] << (8 * i);
+    return value;
+}
+
+static NSError* PWPOSIXError (NSString* path)
+{
+    return [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSFilePathErrorKey: path }];
+}
+
+#pragma mark -
+
+@implementation PWDebugOptionFileStore
+{
+    PWDebugLock                             _lock;
+    int                                     _fd;            // protected by _lock
+    NSMutableDictionary<NSString*, id>*     _values;        // protected by _lock
+    NSUInteger                              _recordCount;   // protected by _lock
+}
+
++ (nullable PWDebugOptionFileStore*) storeWithPath:(NSString*)path error:(NSError**)error
+{
+    NSParameterAssert (path);
+
+    // Two stores appending to the same file would corrupt it.
+    static NSMutableDictionary<NSString*, PWDebugOptionFileStore*>* sStoresByPath;
+    static PWDebugLock sStoresLock = PW_DEBUG_LOCK_INIT;
+
+    path = path.stringByStandardizingPath;
+    PWDebugLockLock (&sStoresLock);
+    if (!sStoresByPath)
+        sStoresByPath = [[NSMutableDictionary alloc] init];
+    PWDebugOptionFileStore* store = sStoresByPath[path];
+    if (!store) {
+        store = [[self alloc] initWithPath:path error:error];
+        if (store)
+            sStoresByPath[path] = store;
+    }
+    PWDebugLockUnlock (&sStoresLock);
+    return store;
+}
+
+- (nullable instancetype) initWithPath:(NSString*)path error:(NSError**)error
+{
+    NSParameterAssert (path);
+
+    self = [super init];
+    _path   = [path copy];
+    _values = [[NSMutableDictionary alloc] init];
+    _fd     = -1;
+    PWDebugLockInit (&_lock);
+
+    if (![self loadFile:error])
+        return nil;
+    if (_recordCount >= PWCompactionMinRecords && _recordCount > PWCompactionRatio * _values.count)
+        [self compact:NULL];
+    return self;
+}
+
+- (void) dealloc
+{
+    if (_fd >= 0)
+        close (_fd);
+    PWDebugLockDestroy (&_lock);
+}
+
+#pragma mark - Loading
+
+// Maps the file and replays all records in one sequential pass.
+- (BOOL) loadFile:(NSError**)error
+{
+    _fd = open (_path.fileSystemRepresentation, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        if (error)
+            *error = PWPOSIXError (_path);
+        return NO;
+    }
+
+    struct stat fileStat;
+    if (fstat (_fd, &fileStat) != 0) {
+        if (error)
+            *error = PWPOSIXError (_path);
+        return NO;
+    }
+
+    size_t fileSize = (size_t)fileStat.st_size;
+    if (fileSize < PWHeaderSize) {
+        // New file, or one which did not even get its header written.
+        NSMutableData* header = [[NSMutableData alloc] init];
+        PWAppendInteger (header, PWFileStoreMagic, 4);
+        PWAppendInteger (header, PWFileStoreVersion, 4);
+        if (ftruncate (_fd, 0) != 0 || ![self appendData:header]) {
+            if (error)
+                *error = PWPOSIXError (_path);
+            return NO;
+        }
+        return YES;
+    }
+
+    const uint8_t* bytes = mmap (NULL, fileSize, PROT_READ, MAP_PRIVATE, _fd, 0);
+    if (bytes == MAP_FAILED) {
+        if (error)
+            *error = PWPOSIXError (_path);
+        return NO;
+    }
+
+    if (   PWReadInteger (bytes, 4) != PWFileStoreMagic
+        || PWReadInteger (bytes + 4, 4) != PWFileStoreVersion) {
+        munmap ((void*)bytes, fileSize);
+        if (error)
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError
+                                     userInfo:@{ NSFilePathErrorKey: _path }];
+        return NO;
+    }
+
+    size_t offset = PWHeaderSize;
+    while (offset + PWRecordHeaderSize <= fileSize) {
+        size_t length = (size_t)PWReadInteger (bytes + offset, 4);
+        uint32_t crc  = (uint32_t)PWReadInteger (bytes + offset + 4, 4);
+        const uint8_t* payload = bytes + offset + PWRecordHeaderSize;
+        if (   length > fileSize - offset - PWRecordHeaderSize
+            || PWCRC32 (payload, length) != crc
+            || ![self applyPayload:payload length:length])
+            break;  // torn or corrupt record, everything from here on is dropped
+        offset += PWRecordHeaderSize + length;
+        ++_recordCount;
+    }
+    munmap ((void*)bytes, fileSize);
+
+    if (offset < fileSize) {
+        NSLog (@"Dropping %zu bytes of incomplete records at the end of debug option store \"%@\".",
+               fileSize - offset, _path);
+        if (ftruncate (_fd, (off_t)offset) != 0) {
+            if (error)
+                *error = PWPOSIXError (_path);
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (BOOL) applyPayload:(const uint8_t*)payload length:(size_t)length
+{
+    if (length < 3)
+        return NO;
+    PWRecordType type = payload[0];
+    size_t keyLength = (size_t)PWReadInteger (payload + 1, 2);
+    if (3 + keyLength > length)
+        return NO;
+    NSString* key = [[NSString alloc] initWithBytes:payload + 3 length:keyLength encoding:NSUTF8StringEncoding];
+    if (!key)
+        return NO;
+
+    const uint8_t* value = payload + 3 + keyLength;
+    size_t valueLength = length - 3 - keyLength;
+    switch (type) {
+        case PWRecordTypeRemove:
+            if (valueLength != 0)
+                return NO;
+            [_values removeObjectForKey:key];
+            return YES;
+
+        case PWRecordTypeInteger:
+            if (valueLength != 8)
+                return NO;
+            _values[key] = @((int64_t)PWReadInteger (value, 8));
+            return YES;
+
+        case PWRecordTypeDouble: {
+            if (valueLength != 8)
+                return NO;
+            uint64_t bits = PWReadInteger (value, 8);
+            double doubleValue;
+            memcpy (&doubleValue, &bits, sizeof doubleValue);
+            _values[key] = @(doubleValue);
+            return YES;
+        }
+
+        case PWRecordTypeString: {
+            if (valueLength < 4 || valueLength - 4 != PWReadInteger (value, 4))
+                return NO;
+            NSString* string = [[NSString alloc] initWithBytes:value + 4 length:valueLength - 4
+                                                      encoding:NSUTF8StringEncoding];
+            if (!string)
+                return NO;
+            _values[key] = string;
+            return YES;
+        }
+    }
+    return NO;
+}
+
+#pragma mark - Writing
+
++ (void) appendRecordForKey:(NSString*)key value:(nullable id)value toData:(NSMutableData*)data
+{
+    NSData* keyData = [key dataUsingEncoding:NSUTF8StringEncoding];
+    NSAssert (keyData.length <= UINT16_MAX, @"key too long");
+
+    NSMutableData* payload = [[NSMutableData alloc] init];
+    if (!value) {
+        PWAppendInteger (payload, PWRecordTypeRemove, 1);
+        PWAppendInteger (payload, keyData.length, 2);
+        [payload appendData:keyData];
+    } else if ([value isKindOfClass:NSString.class]) {
+        NSData* stringData = [(NSString*)value dataUsingEncoding:NSUTF8StringEncoding];
+        PWAppendInteger (payload, PWRecordTypeString, 1);
+        PWAppendInteger (payload, keyData.length, 2);
+        [payload appendData:keyData];
+        PWAppendInteger (payload, stringData.length, 4);
+        [payload appendData:stringData];
+    } else {
+        NSNumber* number = value;
+        const char* type = number.objCType;
+        BOOL isFloatingPoint = (strcmp (type, @encode (double)) == 0 || strcmp (type, @encode (float)) == 0);
+        PWAppendInteger (payload, isFloatingPoint ? PWRecordTypeDouble : PWRecordTypeInteger, 1);
+        PWAppendInteger (payload, keyData.length, 2);
+        [payload appendData:keyData];
+        if (isFloatingPoint) {
+            double doubleValue = number.doubleValue;
+            uint64_t bits;
+            memcpy (&bits, &doubleValue, sizeof bits);
+            PWAppendInteger (payload, bits, 8);
+        } else
+            PWAppendInteger (payload, (uint64_t)number.longLongValue, 8);
+    }
+
+    PWAppendInteger (data, payload.length, 4);
+    PWAppendInteger (data, PWCRC32 (payload.bytes, payload.length), 4);
+    [data appendData:payload];
+}
+
+// Must be called with _lock held, or during initialization.
+- (BOOL) appendData:(NSData*)data
+{
+    const uint8_t* bytes = data.bytes;
+    size_t remaining = data.length;
+    while (remaining > 0) {
+        ssize_t written = write (_fd, bytes, remaining);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            NSLog (@"Failed to write debug option store \"%@\": %s", _path, strerror (errno));
+            return NO;
+        }
+        bytes += written;
+        remaining -= (size_t)written;
+    }
+    return YES;
+}
+
+- (nullable id) objectForKey:(NSString*)key
+{
+    NSParameterAssert (key);
+
+    PWDebugLockLock (&_lock);
+    id value = _values[key];
+    PWDebugLockUnlock (&_lock);
+    return value;
+}
+
+- (void) setObject:(nullable id)value forKey:(NSString*)key
+{
+    NSParameterAssert (key);
+    NSParameterAssert (!value || [value isKindOfClass:NSNumber.class] || [value isKindOfClass:NSString.class]);
+
+    PWDebugLockLock (&_lock);
+    id oldValue = _values[key];
+    if (value ? ![oldValue isEqual:value] : oldValue != nil) {
+        NSMutableData* record = [[NSMutableData alloc] init];
+        [self.class appendRecordForKey:key value:value toData:record];
+        if ([self appendData:record]) {
+            if (value)
+                _values[key] = value;
+            else
+                [_values removeObjectForKey:key];
+            ++_recordCount;
+            if (_recordCount >= PWCompactionMinRecords && _recordCount > PWCompactionRatio * _values.count)
+                [self compactLocked:NULL];
+        }
+    }
+    PWDebugLockUnlock (&_lock);
+}
+
+- (void) removeObjectForKey:(NSString*)key
+{
+    [self setObject:nil forKey:key];
+}
+
+- (BOOL) synchronize
+{
+    PWDebugLockLock (&_lock);
+    BOOL success = (fsync (_fd) == 0);
+    PWDebugLockUnlock (&_lock);
+    return success;
+}
+
+- (NSUInteger) recordCount
+{
+    PWDebugLockLock (&_lock);
+    NSUInteger recordCount = _recordCount;
+    PWDebugLockUnlock (&_lock);
+    return recordCount;
+}
+
+- (NSUInteger) count
+{
+    PWDebugLockLock (&_lock);
+    NSUInteger count = _values.count;
+    PWDebugLockUnlock (&_lock);
+    return count;
+}
+
+#pragma mark - Compaction
+
+- (BOOL) compact:(NSError**)error
+{
+    PWDebugLockLock (&_lock);
+    BOOL success = [self compactLocked:error];
+    PWDebugLockUnlock (&_lock);
+    return success;
+}
+
+// Must be called with _lock held. Writes the live values to a temporary file, which then replaces the store file.
+// A crash leaves either the old or the new file in place.
+- (BOOL) compactLocked:(NSError**)error
+{
+    NSMutableData* data = [[NSMutableData alloc] init];
+    PWAppendInteger (data, PWFileStoreMagic, 4);
+    PWAppendInteger (data, PWFileStoreVersion, 4);
+    for (NSString* iKey in _values)
+        [self.class appendRecordForKey:iKey value:_values[iKey] toData:data];
+
+    NSString* temporaryPath = [_path stringByAppendingString:@".compacting"];
+    int fd = open (temporaryPath.fileSystemRepresentation, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        if (error)
+            *error = PWPOSIXError (temporaryPath);
+        return NO;
+    }
+
+    int oldFD = _fd;
+    _fd = fd;
+    BOOL success = [self appendData:data] && fsync (fd) == 0
+                && rename (temporaryPath.fileSystemRepresentation, _path.fileSystemRepresentation) == 0;
+    if (!success) {
+        if (error)
+            *error = PWPOSIXError (_path);
+        _fd = oldFD;
+        close (fd);
+        unlink (temporaryPath.fileSystemRepresentation);
+        return NO;
+    }
+
+    close (oldFD);
+    _recordCount = _values.count;
+
+    // Make the rename itself durable.
+    int directoryFD = open (_path.stringByDeletingLastPathComponent.fileSystemRepresentation, O_RDONLY | O_CLOEXEC);
+    if (directoryFD >= 0) {
+        fsync (directoryFD);
+        close (directoryFD);
+    }
+    return YES;
+}
+
+#pragma mark - Suites
+
+- (id<PWDebugOptionStore>) storeForSuiteName:(NSString*)suiteName
+{
+    NSParameterAssert (suiteName);
+
+    NSString* fileName = [NSString stringWithFormat:@"%@.%@", _path.lastPathComponent.stringByDeletingPathExtension, suiteName];
+    if (_path.pathExtension.length > 0)
+        fileName = [fileName stringByAppendingPathExtension:_path.pathExtension];
+    NSString* path = [_path.stringByDeletingLastPathComponent stringByAppendingPathComponent:fileName];
+
+    NSError* error;
+    PWDebugOptionFileStore* store = [self.class storeWithPath:path error:&error];
+    if (!store) {
+        NSLog (@"Can’t open debug option store \"%@\", using \"%@\" instead: %@", path, _path, error);
+        return self;
+    }
+    return store;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
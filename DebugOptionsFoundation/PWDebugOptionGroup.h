@@ -10,10 +10,24 @@
 //
 
 #import <Foundation/Foundation.h>
+#import <DebugOptionsFoundation/PWDebugOptionStore.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
 @class PWDebugOption;
+@class PWDebugCPUBudgetPolicy;
+
+/// Posted once per change of PWDebugOptionGroup.isEnabled, after the active state of all affected options has been
+/// updated. Object is the group whose isEnabled changed.
+extern NSNotificationName const PWDebugOptionGroupEnabledStateDidChangeNotification;
+
+/// Posted after an option was added to a group. Object is the group, the option is in the user info under
+/// PWDebugOptionGroupAddedOptionKey.
+extern NSNotificationName const PWDebugOptionGroupDidAddOptionNotification;
+extern NSString* const PWDebugOptionGroupAddedOptionKey;
+
+/// Posted after the options of a group were sorted. Object is the group.
+extern NSNotificationName const PWDebugOptionGroupDidSortOptionsNotification;
 
 
 @interface PWDebugOptionGroup : NSObject
@@ -23,7 +37,27 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, readonly, copy, nullable) NSString*                   userDefaultsSuiteName;
 
-@property (nonatomic, readonly, copy)           NSArray<PWDebugOption*>*    options;
+/// Snapshot of the options, safe to iterate while other threads add or sort options.
+@property (atomic, readonly, copy)              NSArray<PWDebugOption*>*    options;
+
+/// The group containing this group as sub group, nil for the root group.
+@property (nonatomic, readonly, weak, nullable) PWDebugOptionGroup*         parentGroup;
+
+/// Master switch of the group, default is YES. Disabling a group masks the active state (see DEBUG_OPTION_ACTIVE)
+/// of all options in the group and its sub groups.
+@property (nonatomic, readwrite)                BOOL                        isEnabled;
+
+/// YES if this group and all of its ancestors are enabled.
+@property (nonatomic, readonly)                 BOOL                        isEffectivelyEnabled;
+
+@property (nonatomic, readonly, copy)           NSString*                   defaultsKey;
+
+/// CPU budget for the switches in this group and its sub groups which measure their guarded scopes but have no
+/// policy of their own. Sub groups may override it.
+@property (atomic, readwrite, strong, nullable) PWDebugCPUBudgetPolicy*     cpuBudgetPolicy;
+
+/// The policy of this group or its nearest ancestor with a policy.
+@property (nonatomic, readonly, nullable)       PWDebugCPUBudgetPolicy*     effectiveCPUBudgetPolicy;
 
 - (void) addOption:(PWDebugOption*)anOption;
 
@@ -33,10 +67,35 @@ NS_ASSUME_NONNULL_BEGIN
 /// nil if no item with 'title' exists.
 - (nullable __kindof PWDebugOption*) optionWithTitle:(NSString*)title;
 
+/// nil if no item was added with 'propertyName'.
+- (nullable __kindof PWDebugOption*) optionWithPropertyName:(NSString*)propertyName;
+
+/// Replaces the options with a sorted copy, existing snapshots keep their order. Posts
+/// PWDebugOptionGroupDidSortOptionsNotification.
 - (void) sortOptionsUsingComparator:(NSComparator)comparator;
 
+/// Load the state of this group, its options and sub groups. Uses the store for userDefaultsSuiteName instead of
+/// 'store' if the group has a suite name.
+- (void) loadStateFromStore:(id<PWDebugOptionStore>)store;
+
+/// Same as -loadStateFromStore:.
 - (void) loadStateFromUserDefaults:(NSUserDefaults*)userDefaults;
 
+/// The store the state was loaded from, nil before loading.
+@property (nonatomic, readonly, strong, nullable) id<PWDebugOptionStore>    store;
+
+/// Save isEnabled in the store.
+- (void) saveState;
+
+/// Called by options after their value changed to recompute their active state.
+- (void) updateActiveStateOfOption:(PWDebugOption*)option;
+
+/// Current values of all counters in this group and its sub groups, keyed by the counters’ names.
+- (NSDictionary<NSString*, NSNumber*>*) counterSnapshot;
+
+/// Reset all counters in this group and its sub groups.
+- (void) resetCounters;
+
 @end
 
 #pragma mark -
@@ -46,15 +105,19 @@ extern NSString* const PWDebugOptionMenuIsEnabledKey;
 
 @interface PWRootDebugOptionGroup : PWDebugOptionGroup
 
-/// Create the complete tree of groups and options and load the status from user defaults.
+/// Create the complete tree of groups and options and load the status from defaultStore.
 /// Creates a new tree each time this is called, which should be once only.
 + (PWRootDebugOptionGroup*) createRootGroup;
 
+/// Backend for the root group and isDebugMenuEnabled. Standard user defaults, unless the environment variable
+/// PW_DEBUG_OPTIONS_STORE names the path of a PWDebugOptionFileStore. Set it before the root group is created.
+@property (atomic, readwrite, strong, class) id<PWDebugOptionStore>     defaultStore;
+
 /// Ensure there’s a single shared instance of the debug option tree.
 @property (readonly, strong, class) PWRootDebugOptionGroup* sharedRootGroup;
 
-/// Always YES if NDEBUG is not defined, else the state of the user default value under PWDebugOptionMenuIsEnabledKey.
-/// Setter sets user default value, independent of NDEBUG state.
+/// Always YES if NDEBUG is not defined, else the value in defaultStore under PWDebugOptionMenuIsEnabledKey.
+/// Setter sets the value in defaultStore, independent of NDEBUG state.
 /// Note: convenience for the UI layer, not used at this layer.
 @property (nonatomic, readwrite, class) BOOL    isDebugMenuEnabled;
 
@@ -13,14 +13,23 @@
 
 #import "PWDebugOptionGroup.h"
 #import "PWDebugOptions.h"
+#import "PWDebugOptionFileStore.h"
 //#import "NSArray-PWExtensions.h"
 #import <objc/runtime.h>
-#import <os/lock.h>
+#import "PWDebugLock.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 NSString* const PWDebugOptionMenuIsEnabledKey = @"DebugOptionMenuIsEnabled";
 
+NSNotificationName const PWDebugOptionGroupEnabledStateDidChangeNotification = @"PWDebugOptionGroupEnabledStateDidChange";
+NSNotificationName const PWDebugOptionGroupDidAddOptionNotification = @"PWDebugOptionGroupDidAddOption";
+NSString* const PWDebugOptionGroupAddedOptionKey = @"option";
+NSNotificationName const PWDebugOptionGroupDidSortOptionsNotification = @"PWDebugOptionGroupDidSortOptions";
+
+// Serializes changes of the enabled state of groups with updates of the active state of options.
+static PWDebugLock sEffectiveStateLock = PW_DEBUG_LOCK_INIT;
+
 /// Value object for registering KV-observations on group classes.
 @interface PWDebugOptionGroupObservationInfo : NSObject
 
@@ -42,18 +51,39 @@ NSString* const PWDebugOptionMenuIsEnabledKey = @"DebugOptionMenuIsEnabled";
 
 @implementation PWDebugOptionGroup
 {
-    NSMutableArray<PWDebugOption*>* _options;
+    NSArray<PWDebugOption*>*        _options;               // protected by _optionsLock, replaced on every change
+    PWDebugLock                     _optionsLock;
+    BOOL                            _enabled;               // protected by sEffectiveStateLock
+    _Atomic (BOOL)                  _effectivelyEnabled;    // written with sEffectiveStateLock held
 }
 
-@synthesize options = _options;
+@synthesize cpuBudgetPolicy = _cpuBudgetPolicy;
 
 - (instancetype) initWithUserDefaultsSuiteName:(nullable NSString*)userDefaultsSuiteName
 {
     self = [super init];
     _userDefaultsSuiteName = [userDefaultsSuiteName copy];
-    _options = [[NSMutableArray alloc] init];
+    _options = @[];
+    PWDebugLockInit (&_optionsLock);
+    _enabled = YES;
+    _effectivelyEnabled = YES;
+
+    // Call all methods which begin with 'createOption', then all which begin with 'configureOption'. The latter
+    // attach policies to options created by the former.
+    [self performMethodsWithPrefix:@"createOption"];
+    [self performMethodsWithPrefix:@"configureOption"];
+    return self;
+}
+
+- (void) dealloc
+{
+    PWDebugLockDestroy (&_optionsLock);
+}
+
+- (void) performMethodsWithPrefix:(NSString*)prefix
+{
+    NSParameterAssert (prefix);
 
-    // Call all methods which begin with 'createOption'.
     Method* methods = class_copyMethodList (self.class, /*outCount =*/NULL);
     if (methods) { // is nil if the class does not have any methods on this hierarchy level
         for (Method* iMethod = methods; *iMethod; ++iMethod) {
@@ -61,8 +91,7 @@ NSString* const PWDebugOptionMenuIsEnabledKey = @"DebugOptionMenuIsEnabled";
             if (method_getNumberOfArguments (*iMethod) == 2) {
                 SEL iSel = method_getName (*iMethod);
                 NSString* iSelName = NSStringFromSelector (iSel);
-                if ([iSelName hasPrefix:@"createOption"]) {
-                    // Create the option.
+                if ([iSelName hasPrefix:prefix]) {
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Warc-performSelector-leaks"
                     [self performSelector:iSel];
@@ -72,26 +101,65 @@ NSString* const PWDebugOptionMenuIsEnabledKey = @"DebugOptionMenuIsEnabled";
         }
         free (methods);
     }
-    return self;
 }
 
-- (void) loadStateFromUserDefaults:(NSUserDefaults*)userDefaults
+- (void) loadStateFromStore:(id<PWDebugOptionStore>)store
 {
-    NSParameterAssert (userDefaults);
+    NSParameterAssert (store);
 
-    // Use a specific user defaults suite if requested by providing a userDefaultsSuiteName.
+    // Use a specific store if requested by providing a userDefaultsSuiteName.
     // Used to share debug options inside an app group.
     if (_userDefaultsSuiteName)
-        userDefaults = [[NSUserDefaults alloc] initWithSuiteName:_userDefaultsSuiteName];
+        store = [store storeForSuiteName:_userDefaultsSuiteName];
+    _store = store;
+
+    // Groups are loaded top-down, therefore the effective state of the parent is already up to date.
+    NSNumber* enabled = [store objectForKey:self.defaultsKey];
+    if (enabled)
+        [self setEnabled:enabled.boolValue notify:NO];
+
+    for (PWDebugOption* iOption in self.options)
+        [iOption loadStateFromStore:store];
+}
+
+- (void) loadStateFromUserDefaults:(NSUserDefaults*)userDefaults
+{
+    NSParameterAssert (userDefaults);
+    [self loadStateFromStore:userDefaults];
+}
+
+- (void) saveState
+{
+    if (_store) {
+        [_store setObject:@(self.isEnabled) forKey:self.defaultsKey];
+        [_store synchronize]; // make it persistent even if the app is killed soon after
+    }
+}
+
+- (NSString*) defaultsKey
+{
+    return [@"DebugOptionGroup_" stringByAppendingString:NSStringFromClass (self.class)];
+}
+
+#pragma mark - Options
 
-    for (PWDebugOption* iOption in _options)
-        [iOption loadStateFromUserDefaults:userDefaults];
+// Readers get an immutable snapshot, therefore they can iterate while other threads add or sort options.
+- (NSArray<PWDebugOption*>*) options
+{
+    PWDebugLockLock (&_optionsLock);
+    NSArray<PWDebugOption*>* options = _options;
+    PWDebugLockUnlock (&_optionsLock);
+    return options;
 }
 
 - (void) addOption:(PWDebugOption*)option
 {
     NSParameterAssert ([option isKindOfClass:PWDebugOption.class]);
-    [_options addObject:option];
+
+    PWDebugLockLock (&_optionsLock);
+    _options = [_options arrayByAddingObject:option];
+    PWDebugLockUnlock (&_optionsLock);
+    [self didAddOption:option];
 }
 
 - (void) addOption:(PWDebugOption*)option withPropertyName:(NSString*)propertyName
@@ -99,34 +167,206 @@ NSString* const PWDebugOptionMenuIsEnabledKey = @"DebugOptionMenuIsEnabled";
     NSParameterAssert ([option isKindOfClass:PWDebugOption.class]);
     NSParameterAssert (propertyName);
 
-    [_options addObject:option];
+    // Set up before publishing the option, lookups by property name may run concurrently.
     option.groupClass = self.class;
     option.propertyName = propertyName;
+    PWDebugLockLock (&_optionsLock);
+    _options = [_options arrayByAddingObject:option];
+    PWDebugLockUnlock (&_optionsLock);
+    [self didAddOption:option];
+}
+
+- (void) didAddOption:(PWDebugOption*)option
+{
+    option.group = self;
+    if ([option isKindOfClass:PWDebugOptionSubGroup.class]) {
+        PWDebugOptionGroup* subGroup = ((PWDebugOptionSubGroup*)option).subGroup;
+        subGroup->_parentGroup = self;
+        PWDebugLockLock (&sEffectiveStateLock);
+        [subGroup updateEffectiveStateWithParentEnabled:_effectivelyEnabled];
+        PWDebugLockUnlock (&sEffectiveStateLock);
+        // The options of the sub group were configured before it had a parent, restart them with inherited budgets.
+        [subGroup updateCPUBudgetMonitors];
+    } else
+        [self updateActiveStateOfOption:option];
+
+    [NSNotificationCenter.defaultCenter postNotificationName:PWDebugOptionGroupDidAddOptionNotification
+                                                      object:self
+                                                    userInfo:@{ PWDebugOptionGroupAddedOptionKey: option }];
 }
 
 - (nullable PWDebugOption*) optionWithTitle:(NSString*)title
 {
     NSParameterAssert (title);
-    NSUInteger index = [_options indexOfObjectPassingTest:^(PWDebugOption* iOption, NSUInteger idx, BOOL* stop) {
+    NSArray<PWDebugOption*>* options = self.options;
+    NSUInteger index = [options indexOfObjectPassingTest:^(PWDebugOption* iOption, NSUInteger idx, BOOL* stop) {
         return [iOption.title isEqualToString:title];
     }];
-    return (index != NSNotFound) ? _options[index] : nil;
+    return (index != NSNotFound) ? options[index] : nil;
+}
+
+- (nullable PWDebugOption*) optionWithPropertyName:(NSString*)propertyName
+{
+    NSParameterAssert (propertyName);
+    NSArray<PWDebugOption*>* options = self.options;
+    NSUInteger index = [options indexOfObjectPassingTest:^(PWDebugOption* iOption, NSUInteger idx, BOOL* stop) {
+        return [iOption.propertyName isEqualToString:propertyName];
+    }];
+    return (index != NSNotFound) ? options[index] : nil;
 }
 
 - (void) sortOptionsUsingComparator:(NSComparator)comparator
 {
     NSParameterAssert (comparator);
-    [_options sortUsingComparator:comparator];
+
+    // Sort a snapshot outside of the lock and publish it unless an option was added meanwhile, in which case retry.
+    for (;;) {
+        NSArray<PWDebugOption*>* options = self.options;
+        NSArray<PWDebugOption*>* sortedOptions = [options sortedArrayUsingComparator:comparator];
+        PWDebugLockLock (&_optionsLock);
+        BOOL unchanged = (_options == options);
+        if (unchanged)
+            _options = sortedOptions;
+        PWDebugLockUnlock (&_optionsLock);
+        if (unchanged)
+            break;
+    }
+    [NSNotificationCenter.defaultCenter postNotificationName:PWDebugOptionGroupDidSortOptionsNotification object:self];
+}
+
+#pragma mark - Enabled State
+
+- (BOOL) isEnabled
+{
+    PWDebugLockLock (&sEffectiveStateLock);
+    BOOL enabled = _enabled;
+    PWDebugLockUnlock (&sEffectiveStateLock);
+    return enabled;
+}
+
+- (void) setIsEnabled:(BOOL)enabled
+{
+    [self setEnabled:enabled notify:YES];
+}
+
+- (BOOL) isEffectivelyEnabled
+{
+    return _effectivelyEnabled;
+}
+
+- (void) setEnabled:(BOOL)enabled notify:(BOOL)notify
+{
+    PWDebugLockLock (&sEffectiveStateLock);
+    BOOL changed = (_enabled != enabled);
+    if (changed) {
+        _enabled = enabled;
+        PWDebugOptionGroup* parentGroup = _parentGroup;
+        [self updateEffectiveStateWithParentEnabled:parentGroup ? parentGroup->_effectivelyEnabled : YES];
+    }
+    PWDebugLockUnlock (&sEffectiveStateLock);
+
+    // One notification for the whole sub tree instead of one per option.
+    if (changed && notify)
+        [NSNotificationCenter.defaultCenter postNotificationName:PWDebugOptionGroupEnabledStateDidChangeNotification
+                                                          object:self];
+}
+
+// Must be called with sEffectiveStateLock held.
+- (void) updateEffectiveStateWithParentEnabled:(BOOL)parentEnabled
+{
+    BOOL effectivelyEnabled = _enabled && parentEnabled;
+    if (effectivelyEnabled == _effectivelyEnabled)
+        return;     // nothing changes in this sub tree
+
+    _effectivelyEnabled = effectivelyEnabled;
+    for (PWDebugOption* iOption in self.options) {
+        if ([iOption isKindOfClass:PWDebugOptionSubGroup.class])
+            [((PWDebugOptionSubGroup*)iOption).subGroup updateEffectiveStateWithParentEnabled:effectivelyEnabled];
+        else
+            [iOption updateActiveStateForGroupEnabled:effectivelyEnabled];
+    }
+}
+
+- (void) updateActiveStateOfOption:(PWDebugOption*)option
+{
+    NSParameterAssert (option);
+
+    PWDebugLockLock (&sEffectiveStateLock);
+    [option updateActiveStateForGroupEnabled:_effectivelyEnabled];
+    PWDebugLockUnlock (&sEffectiveStateLock);
+}
+
+#pragma mark - CPU Budget
+
+- (nullable PWDebugCPUBudgetPolicy*) cpuBudgetPolicy
+{
+    @synchronized (self) {
+        return _cpuBudgetPolicy;
+    }
+}
+
+- (void) setCpuBudgetPolicy:(nullable PWDebugCPUBudgetPolicy*)policy
+{
+    @synchronized (self) {
+        _cpuBudgetPolicy = policy;
+    }
+    [self updateCPUBudgetMonitors];
+}
+
+- (nullable PWDebugCPUBudgetPolicy*) effectiveCPUBudgetPolicy
+{
+    PWDebugCPUBudgetPolicy* policy = self.cpuBudgetPolicy;
+    return policy ? policy : self.parentGroup.effectiveCPUBudgetPolicy;
+}
+
+- (void) updateCPUBudgetMonitors
+{
+    for (PWDebugOption* iOption in self.options) {
+        if ([iOption isKindOfClass:PWDebugSwitchOption.class])
+            [(PWDebugSwitchOption*)iOption updateCPUBudgetMonitor];
+        else if ([iOption isKindOfClass:PWDebugOptionSubGroup.class])
+            [((PWDebugOptionSubGroup*)iOption).subGroup updateCPUBudgetMonitors];
+    }
+}
+
+#pragma mark - Counters
+
+- (NSDictionary<NSString*, NSNumber*>*) counterSnapshot
+{
+    NSMutableDictionary<NSString*, NSNumber*>* snapshot = [[NSMutableDictionary alloc] init];
+    [self addCountersToSnapshot:snapshot];
+    return snapshot;
+}
+
+- (void) addCountersToSnapshot:(NSMutableDictionary<NSString*, NSNumber*>*)snapshot
+{
+    for (PWDebugOption* iOption in self.options) {
+        if ([iOption isKindOfClass:PWDebugCounterOption.class])
+            snapshot[iOption.propertyName] = @(((PWDebugCounterOption*)iOption).value);
+        else if ([iOption isKindOfClass:PWDebugOptionSubGroup.class])
+            [((PWDebugOptionSubGroup*)iOption).subGroup addCountersToSnapshot:snapshot];
+    }
+}
+
+- (void) resetCounters
+{
+    for (PWDebugOption* iOption in self.options) {
+        if ([iOption isKindOfClass:PWDebugCounterOption.class])
+            [(PWDebugCounterOption*)iOption reset];
+        else if ([iOption isKindOfClass:PWDebugOptionSubGroup.class])
+            [((PWDebugOptionSubGroup*)iOption).subGroup resetCounters];
+    }
 }
 
 #pragma mark - KV Observing
 
 // Manual registration of observers on group classes (as opposed to instances).
 
-// Protected by sObservationsLock.
-static NSMutableArray<PWDebugOptionGroupObservationInfo*>* sObservations;
+// Protected by sObservationsLock. Replaced on every change, so that notifying observers works on a snapshot which
+// costs one retain under the lock, however many observers are registered.
+static NSArray<PWDebugOptionGroupObservationInfo*>* sObservations;
 
-static os_unfair_lock sObservationsLock = OS_UNFAIR_LOCK_INIT;
+static PWDebugLock sObservationsLock = PW_DEBUG_LOCK_INIT;
 
 + (void) addObserver:(NSObject*)observer
           forKeyPath:(NSString*)keyPath
@@ -141,29 +381,43 @@ static os_unfair_lock sObservationsLock = OS_UNFAIR_LOCK_INIT;
                                                                                                   options:options
                                                                                                   context:context
                                                                                             forGroupClass:self];
-    os_unfair_lock_lock (&sObservationsLock);
-    if (!sObservations)
-        sObservations = [[NSMutableArray alloc] init];
-    [sObservations addObject:info];
-    os_unfair_lock_unlock (&sObservationsLock);
+    PWDebugLockLock (&sObservationsLock);
+    sObservations = sObservations ? [sObservations arrayByAddingObject:info] : @[info];
+    PWDebugLockUnlock (&sObservationsLock);
 }
 
 + (void) removeObserver:(NSObject*)observer
              forKeyPath:(NSString*)keyPath
                 context:(nullable void*)context
 {
-    os_unfair_lock_lock (&sObservationsLock);
-    for (NSUInteger i = 0; i < sObservations.count; ) {
-        PWDebugOptionGroupObservationInfo* iInfo = sObservations[i];
-        if (   iInfo.observer == observer
-            && [iInfo.key isEqualToString:keyPath]
-            && iInfo.context == context
-            && iInfo.groupClass == self)
-            [sObservations removeObjectAtIndex:i];
+    PWDebugLockLock (&sObservationsLock);
+    NSArray<PWDebugOptionGroupObservationInfo*>* observations = sObservations;
+    PWDebugLockUnlock (&sObservationsLock);
+
+    // Filter outside of the lock, retry if another thread changed the observations meanwhile. Registrations of
+    // deallocated observers are dropped on the way.
+    for (;;) {
+        NSIndexSet* keptIndexes = [observations indexesOfObjectsPassingTest:^BOOL (PWDebugOptionGroupObservationInfo* iInfo,
+                                                                                   NSUInteger idx, BOOL* stop) {
+            NSObject* iObserver = iInfo.observer;
+            return    iObserver
+                   && !(   iObserver == observer
+                        && [iInfo.key isEqualToString:keyPath]
+                        && iInfo.context == context
+                        && iInfo.groupClass == self);
+        }];
+        NSArray<PWDebugOptionGroupObservationInfo*>* keptObservations = [observations objectsAtIndexes:keptIndexes];
+
+        PWDebugLockLock (&sObservationsLock);
+        BOOL unchanged = (sObservations == observations);
+        if (unchanged)
+            sObservations = keptObservations;
         else
-            ++i;
+            observations = sObservations;
+        PWDebugLockUnlock (&sObservationsLock);
+        if (unchanged)
+            break;
     }
-    os_unfair_lock_unlock (&sObservationsLock);
 }
 
 + (void) willChangeValueForKey:(NSString*)key
@@ -177,20 +431,18 @@ static os_unfair_lock sObservationsLock = OS_UNFAIR_LOCK_INIT;
 {
     NSParameterAssert (key);
 
-    NSMutableArray<PWDebugOptionGroupObservationInfo*>* matchingObservations = [[NSMutableArray alloc] init];
-    os_unfair_lock_lock (&sObservationsLock);
-    for (PWDebugOptionGroupObservationInfo* iInfo in sObservations) {
-        if (   [iInfo.key isEqualToString:key]
-            && iInfo.groupClass == self)
-            [matchingObservations addObject:iInfo];
+    PWDebugLockLock (&sObservationsLock);
+    NSArray<PWDebugOptionGroupObservationInfo*>* observations = sObservations;
+    PWDebugLockUnlock (&sObservationsLock);
+
+    for (PWDebugOptionGroupObservationInfo* iInfo in observations) {
+        if (   iInfo.groupClass == self
+            && [iInfo.key isEqualToString:key])
+            [iInfo.observer observeValueForKeyPath:iInfo.key
+                                          ofObject:self
+                                            change:@{ NSKeyValueChangeKindKey: @(NSKeyValueChangeSetting) }
+                                           context:iInfo.context];
     }
-    os_unfair_lock_unlock (&sObservationsLock);
-
-    for (PWDebugOptionGroupObservationInfo* iInfo in matchingObservations)
-        [iInfo.observer observeValueForKeyPath:iInfo.key
-                                      ofObject:self
-                                        change:@{ NSKeyValueChangeKindKey: @(NSKeyValueChangeSetting) }
-                                       context:iInfo.context];
     [super didChangeValueForKey:key];
 }
 
@@ -203,10 +455,38 @@ static os_unfair_lock sObservationsLock = OS_UNFAIR_LOCK_INIT;
 + (PWRootDebugOptionGroup*) createRootGroup
 {
     PWRootDebugOptionGroup* rootGroup = [[self alloc] initWithUserDefaultsSuiteName:nil];
-    [rootGroup loadStateFromUserDefaults:NSUserDefaults.standardUserDefaults];
+    [rootGroup loadStateFromStore:self.defaultStore];
     return rootGroup;
 }
 
+static id<PWDebugOptionStore> sDefaultStore;
+
++ (id<PWDebugOptionStore>) defaultStore
+{
+    @synchronized (PWRootDebugOptionGroup.class) {
+        if (!sDefaultStore) {
+            NSString* path = NSProcessInfo.processInfo.environment[@"PW_DEBUG_OPTIONS_STORE"];
+            if (path.length > 0) {
+                NSError* error;
+                sDefaultStore = [PWDebugOptionFileStore storeWithPath:path error:&error];
+                if (!sDefaultStore)
+                    NSLog (@"Can’t open debug option store \"%@\", using user defaults instead: %@", path, error);
+            }
+            if (!sDefaultStore)
+                sDefaultStore = NSUserDefaults.standardUserDefaults;
+        }
+        return sDefaultStore;
+    }
+}
+
++ (void) setDefaultStore:(id<PWDebugOptionStore>)store
+{
+    NSParameterAssert (store);
+    @synchronized (PWRootDebugOptionGroup.class) {
+        sDefaultStore = store;
+    }
+}
+
 + (PWRootDebugOptionGroup*) sharedRootGroup
 {
     static PWRootDebugOptionGroup* sSharedRootGroup;
@@ -220,7 +500,7 @@ static os_unfair_lock sObservationsLock = OS_UNFAIR_LOCK_INIT;
 + (BOOL) isDebugMenuEnabled
 {
 #ifdef NDEBUG
-    return [NSUserDefaults.standardUserDefaults boolForKey:PWDebugOptionMenuIsEnabledKey];
+    return [[self.defaultStore objectForKey:PWDebugOptionMenuIsEnabledKey] boolValue];
 #else
     return YES;
 #endif
@@ -228,7 +508,9 @@ static os_unfair_lock sObservationsLock = OS_UNFAIR_LOCK_INIT;
 
 + (void) setIsDebugMenuEnabled:(BOOL)value
 {
-    [NSUserDefaults.standardUserDefaults setBool:value forKey:PWDebugOptionMenuIsEnabledKey];
+    id<PWDebugOptionStore> store = self.defaultStore;
+    [store setObject:@(value) forKey:PWDebugOptionMenuIsEnabledKey];
+    [store synchronize];
 }
 
 @end
@@ -49,7 +49,8 @@
 
  This adds the new sub group as one option of a parent group, forming a hierarchy of option groups.
  The second variant provides a user defaults suite name which can be used to share debug options between the members
- of an app group. Pass the app group identifier as suiteName in this case.
+ of an app group. Pass the app group identifier as suiteName in this case. With a PWDebugOptionFileStore, the suite is
+ a file next to the store file.
 
  
  Debug option switches -------------------------------------------------------------------------------------------------
@@ -69,7 +70,8 @@
  
  If 'isPersistent' is true, the state of the switch can be made persistent by pressing the option key while selecting
  the menu item. Use DEBUG_OPTION_PERSISTENT or DEBUG_OPTION_NON_PERSISTENT for readability.
- The value is saved under the key "DebugOption_<aName>" in user defaults.
+ The value is saved under the key "DebugOption_<aName>" in PWRootDebugOptionGroup.defaultStore, which is user defaults
+ unless the environment variable PW_DEBUG_OPTIONS_STORE names a PWDebugOptionFileStore.
  
  To use a switch in multiple compilation units, place 
  
@@ -84,6 +86,75 @@
  This creates the variable 'aName' as "extern" with default visibility.
  
  
+ The variables of switches and enumerations live in a dedicated section, each on its own cache line. Reading them
+ directly is a sequentially consistent atomic load. Where that matters, use a relaxed load instead:
+
+    DEBUG_OPTION_READ (aName)
+
+ DEBUG_OPTION_READ_D is the variant for options created with the _D macros.
+
+
+ Each option group has a master switch (PWDebugOptionGroup.isEnabled). Disabling a group masks all switches and
+ enumerations in the group and its sub groups: switches read as NO, enumerations as their default value. The masked
+ value is precomputed whenever a switch or group changes, so checking it costs a single load:
+
+    DEBUG_OPTION_ACTIVE (aName)
+
+ DEBUG_OPTION_ACTIVE_D is the variant for options created with the _D macros. The option variable itself always
+ holds the unmasked value.
+
+
+ Expiring switches and enumerations ------------------------------------------------------------------------------------
+
+ Expensive tracing switches should not stay on by accident. An expiry policy reverts a switch or enumeration to its
+ default value once it has held another value for 'aSeconds' seconds or for 'anEvaluationCount' evaluations, whichever
+ comes first. Pass 0 to disable either limit. A temporary value is never saved in the store.
+
+    DEBUG_OPTION_EXPIRY (aName, targetGroup, aSeconds, anEvaluationCount)
+
+ 'targetGroup' must be the group of the option 'aName'. To use DEBUG_OPTION_EVALUATE in multiple compilation units,
+ place
+
+    DEBUG_OPTION_DECLARE_EXPIRY (aName)
+
+ in a header file and
+
+    DEBUG_OPTION_DEFINE_EXPIRY (aName, targetGroup, aSeconds, anEvaluationCount)
+
+ in an implementation file. Only evaluations through
+
+    DEBUG_OPTION_EVALUATE (aName)
+
+ count against the evaluation limit. It returns the same value as DEBUG_OPTION_ACTIVE. Time limits of all options are
+ served by one shared timer wheel.
+
+
+ CPU budgets -----------------------------------------------------------------------------------------------------------
+
+ A CPU budget makes it safe to turn on costly diagnostics on a loaded machine. The time spent in scopes guarded by a
+ switch is measured, and if it exceeds 'aFraction' of the wall time over a sliding window of 'aWindow' seconds, the
+ switch is turned off. This is logged and posted as PWDebugOptionCPUBudgetExceededNotification.
+
+    DEBUG_OPTION_CPU_BUDGET (aName, targetGroup, aFraction, aWindow)
+
+ 'targetGroup' must be the group of the switch 'aName'. Pass 0 for 'aFraction' and 'aWindow' to use the policy of the
+ group instead, which is set with
+
+    DEBUG_OPTION_GROUP_CPU_BUDGET (aGroup, aFraction, aWindow)
+
+ and applies to the group and its sub groups. To measure a scope in multiple compilation units, place
+
+    DEBUG_OPTION_DECLARE_CPU_BUDGET (aName)
+
+ in a header file and use DEBUG_OPTION_DEFINE_CPU_BUDGET with the same parameters as DEBUG_OPTION_CPU_BUDGET in an
+ implementation file. Measure a scope by placing
+
+    DEBUG_OPTION_MEASURE_CPU (aName);
+
+ at its beginning, typically as the first statement in the block of 'if (DEBUG_OPTION_ACTIVE (aName))'. The measurement
+ costs two reads of the monotonic clock and one sharded counter increment, and ends with the scope.
+
+
  Debug option enumerations ---------------------------------------------------------------------------------------------
  
  An enumeration option is like a switch, but allows a list of integer values instead of just YES and NO.
@@ -104,12 +175,60 @@
     DEBUG_OPTION_DEFINE_ENUM (aName, targetGroup, aTitle, aToolTip, aFlag, aType, aDefaultValue, isPersistent, ...)
 
  
+ Debug option texts ----------------------------------------------------------------------------------------------------
+
+ A text option holds a string, which is nil by default.
+
+    DEBUG_OPTION_TEXT (aName, targetGroup, aTitle, aToolTip, isPersistent)
+    DEBUG_OPTION_DECLARE_TEXT (aName)
+    DEBUG_OPTION_DEFINE_TEXT (aName, targetGroup, aTitle, aToolTip, isPersistent)
+
+ The variable 'aName' is a strong object pointer. Code which may run while the text is changed on another thread must
+ read it with
+
+    DEBUG_OPTION_READ_TEXT (aName)
+
+ 
+ Debug counters --------------------------------------------------------------------------------------------------------
+
+ A counter counts events like cache misses and shows the count in the debug menu, where it can be reset, too.
+ Increments go to one of several shards, each in its own cache line, so counting from many threads is cheap.
+ PWDebugOptionGroup.counterSnapshot returns the values of all counters in a group tree. A reset zeroes the shards one
+ after the other, so increments from other threads during the reset may or may not survive it.
+
+    DEBUG_COUNTER (aName, targetGroup, aTitle, aToolTip)
+
+ This creates a static PWDebugCounter variable named 'aName'. To use a counter in multiple compilation units, place
+
+    DEBUG_DECLARE_COUNTER (aName)
+
+ in a header file and
+
+    DEBUG_DEFINE_COUNTER (aName, targetGroup, aTitle, aToolTip)
+
+ in an implementation file. Count with
+
+    DEBUG_COUNTER_INCREMENT (aName)
+    DEBUG_COUNTER_ADD (aName, delta)
+
+ The _D variants of the increment macros vanish completely in release builds, without evaluating 'delta'.
+
+
  Debug option actions --------------------------------------------------------------------------------------------------
  
  An action executes a block when the option is selected.
 
     DEBUG_OPTION_ACTIONBLOCK (aName, targetGroup, aTitle, aToolTip, block)
 
+ An asynchronous action executes its block on a background queue, which keeps long running diagnostics from
+ blocking the menu. The block has a single NSProgress* parameter, which is used to report progress and must be
+ checked for cancellation. An asynchronous action is not started again while it is still running.
+
+    DEBUG_OPTION_ASYNC_ACTIONBLOCK (aName, targetGroup, aTitle, aToolTip, block)
+    DEBUG_OPTION_ASYNC_ACTIONBLOCK_WITHQUEUE (aName, targetGroup, aTitle, aToolTip, aQueue, block)
+
+ The first variant uses the global queue with utility QoS, the second one runs the block on 'aQueue'.
+
  
  Named observables -----------------------------------------------------------------------------------------------------
 
@@ -180,61 +299,143 @@
 
 #define DEBUG_OPTION_DECLARE_SWITCH(aName, aDefaultValue) __attribute__((visibility("default"))) \
 extern _Atomic (BOOL) aName; \
+__attribute__((visibility("default"))) extern _Atomic (BOOL) aName ## _Active; \
 enum { aName ## _Default_Value = aDefaultValue };
 
 #define DEBUG_OPTION_DEFINE_SWITCH(aName, targetGroup, aTitle, aToolTip, isPersistent) \
-_Atomic (BOOL) aName = aName ## _Default_Value; \
+PW_DEBUG_OPTION_STORAGE _Atomic (BOOL) aName = aName ## _Default_Value; \
+PW_DEBUG_OPTION_STORAGE _Atomic (BOOL) aName ## _Active = aName ## _Default_Value; \
 @implementation targetGroup (aName) \
 - (void) createOption##aName { \
-    [self addOption: \
+    PWDebugSwitchOption* option = \
      [[PWDebugSwitchOption alloc] initWithTitle:aTitle toolTip:aToolTip \
                                   booleanTarget:&aName defaultValue:aName ## _Default_Value \
-                              defaultsKeySuffix:isPersistent ? @#aName : nil] \
-        withPropertyName:@#aName]; \
+                              defaultsKeySuffix:isPersistent ? @#aName : nil]; \
+    option.activeTarget = &aName ## _Active; \
+    [self addOption:option withPropertyName:@#aName]; \
 } \
 @end
 
 #define DEBUG_OPTION_SWITCH(aName, targetGroup, aTitle, aToolTip, aDefaultValue, isPersistent) \
-static _Atomic (BOOL) aName; \
+static PW_DEBUG_OPTION_STORAGE _Atomic (BOOL) aName; \
+static PW_DEBUG_OPTION_STORAGE _Atomic (BOOL) aName ## _Active; \
 @implementation targetGroup (aName) \
 - (void) createOption##aName { \
-    [self addOption: \
+    PWDebugSwitchOption* option = \
      [[PWDebugSwitchOption alloc] initWithTitle:aTitle toolTip:aToolTip \
                                     booleanTarget:&aName defaultValue:aDefaultValue \
-                                defaultsKeySuffix:isPersistent ? @#aName : nil] \
-        withPropertyName:@#aName]; \
+                                defaultsKeySuffix:isPersistent ? @#aName : nil]; \
+    option.activeTarget = &aName ## _Active; \
+    [self addOption:option withPropertyName:@#aName]; \
 } \
 @end
 
 
-#define DEBUG_OPTION_DECLARE_ENUM(aName, aType) __attribute__((visibility("default"))) extern _Atomic (aType) aName;
+#define DEBUG_OPTION_DECLARE_ENUM(aName, aType) __attribute__((visibility("default"))) extern _Atomic (aType) aName; \
+__attribute__((visibility("default"))) extern _Atomic (aType) aName ## _Active;
 
 #define DEBUG_OPTION_DEFINE_ENUM(aName, targetGroup, aTitle, aToolTip, aFlag, aType, aDefaultValue, isPersistent, ...) \
-_Atomic (aType) aName; \
+PW_DEBUG_OPTION_STORAGE _Atomic (aType) aName; \
+PW_DEBUG_OPTION_STORAGE _Atomic (aType) aName ## _Active; \
 @implementation targetGroup (aName) \
 - (void) createOption##aName { \
-    [self addOption: \
+    PWDebugEnumOption* option = \
     [[PWDebugEnumOption alloc] initWithTitle:aTitle toolTip:aToolTip asSubMenu:aFlag \
                                            target:(_Atomic (NSInteger)*)&aName defaultValue:aDefaultValue \
                                 defaultsKeySuffix:isPersistent ? @#aName : nil \
-                                  titlesAndValues:__VA_ARGS__] \
-        withPropertyName:@#aName]; \
+                                  titlesAndValues:__VA_ARGS__]; \
+    option.activeTarget = (_Atomic (NSInteger)*)&aName ## _Active; \
+    [self addOption:option withPropertyName:@#aName]; \
 } \
 @end
 
 #define DEBUG_OPTION_ENUM(aName, targetGroup, aTitle, aToolTip, aFlag, aType, aDefaultValue, isPersistent, ...) \
-static _Atomic (aType) aName; \
+static PW_DEBUG_OPTION_STORAGE _Atomic (aType) aName; \
+static PW_DEBUG_OPTION_STORAGE _Atomic (aType) aName ## _Active; \
 @implementation targetGroup (aName) \
 - (void) createOption##aName { \
-    [self addOption: \
+    PWDebugEnumOption* option = \
     [[PWDebugEnumOption alloc] initWithTitle:aTitle toolTip:aToolTip asSubMenu:aFlag \
                                            target:(_Atomic (NSInteger)*)&aName defaultValue:aDefaultValue \
                                 defaultsKeySuffix:isPersistent ? @#aName : nil \
-                                  titlesAndValues:__VA_ARGS__] \
-        withPropertyName:@#aName]; \
+                                  titlesAndValues:__VA_ARGS__]; \
+    option.activeTarget = (_Atomic (NSInteger)*)&aName ## _Active; \
+    [self addOption:option withPropertyName:@#aName]; \
+} \
+@end
+
+
+#define DEBUG_OPTION_READ(aName) atomic_load_explicit (&(aName), memory_order_relaxed)
+
+#define DEBUG_OPTION_ACTIVE(aName) atomic_load_explicit (&(aName ## _Active), memory_order_relaxed)
+
+
+// The evaluation budget is written on every evaluation, therefore it fills a cache line of its own outside of the
+// option section.
+
+#define DEBUG_OPTION_DECLARE_EXPIRY(aName) __attribute__((visibility("default"))) \
+extern PWDebugEvaluationBudget aName ## _Evaluations;
+
+#define DEBUG_OPTION_DEFINE_EXPIRY(aName, targetGroup, aSeconds, anEvaluationCount) \
+PWDebugEvaluationBudget aName ## _Evaluations; \
+@implementation targetGroup (aName ## _Expiry) \
+- (void) configureOption##aName##Expiry { \
+    PWDebugOption* option = [self optionWithPropertyName:@#aName]; \
+    NSAssert (option, @"no option " #aName " in group " #targetGroup); \
+    [option setExpiryInterval:aSeconds evaluationCount:anEvaluationCount evaluationBudget:&aName ## _Evaluations.value]; \
+} \
+@end
+
+#define DEBUG_OPTION_EXPIRY(aName, targetGroup, aSeconds, anEvaluationCount) \
+static PWDebugEvaluationBudget aName ## _Evaluations; \
+@implementation targetGroup (aName ## _Expiry) \
+- (void) configureOption##aName##Expiry { \
+    PWDebugOption* option = [self optionWithPropertyName:@#aName]; \
+    NSAssert (option, @"no option " #aName " in group " #targetGroup); \
+    [option setExpiryInterval:aSeconds evaluationCount:anEvaluationCount evaluationBudget:&aName ## _Evaluations.value]; \
 } \
 @end
 
+#define DEBUG_OPTION_EVALUATE(aName) \
+    (PWDebugOptionConsumeEvaluation (&aName ## _Evaluations.value), DEBUG_OPTION_ACTIVE (aName))
+
+
+#define DEBUG_OPTION_DECLARE_CPU_BUDGET(aName) __attribute__((visibility("default"))) \
+extern PWDebugCounter aName ## _CPUTime;
+
+#define DEBUG_OPTION_DEFINE_CPU_BUDGET(aName, targetGroup, aFraction, aWindow) \
+PWDebugCounter aName ## _CPUTime; \
+@implementation targetGroup (aName ## _CPUBudget) \
+- (void) configureOption##aName##CPUBudget { \
+    PWDebugSwitchOption* option = [self optionWithPropertyName:@#aName]; \
+    NSAssert ([option isKindOfClass:PWDebugSwitchOption.class], @"no switch " #aName " in group " #targetGroup); \
+    [option setCPUTimeCounter:&aName ## _CPUTime \
+                       policy:(aFraction) > 0 ? [[PWDebugCPUBudgetPolicy alloc] initWithFraction:aFraction window:aWindow] : nil]; \
+} \
+@end
+
+#define DEBUG_OPTION_CPU_BUDGET(aName, targetGroup, aFraction, aWindow) \
+static PWDebugCounter aName ## _CPUTime; \
+@implementation targetGroup (aName ## _CPUBudget) \
+- (void) configureOption##aName##CPUBudget { \
+    PWDebugSwitchOption* option = [self optionWithPropertyName:@#aName]; \
+    NSAssert ([option isKindOfClass:PWDebugSwitchOption.class], @"no switch " #aName " in group " #targetGroup); \
+    [option setCPUTimeCounter:&aName ## _CPUTime \
+                       policy:(aFraction) > 0 ? [[PWDebugCPUBudgetPolicy alloc] initWithFraction:aFraction window:aWindow] : nil]; \
+} \
+@end
+
+#define DEBUG_OPTION_GROUP_CPU_BUDGET(aGroup, aFraction, aWindow) \
+@implementation aGroup (aGroup ## _CPUBudget) \
+- (void) configureOptionCPUBudgetOf##aGroup { \
+    self.cpuBudgetPolicy = [[PWDebugCPUBudgetPolicy alloc] initWithFraction:aFraction window:aWindow]; \
+} \
+@end
+
+#define DEBUG_OPTION_MEASURE_CPU(aName) \
+    __attribute__((cleanup (PWDebugCPUScopeEnd), unused)) \
+    PWDebugCPUScope aName ## _Scope = PWDebugCPUScopeBegin (&aName ## _CPUTime)
+
 
 #define DEBUG_OPTION_DECLARE_TEXT(aName) __attribute__((visibility("default"))) \
 extern NSString* aName; \
@@ -263,6 +464,38 @@ static NSString* aName; \
 } \
 @end
 
+#define DEBUG_OPTION_READ_TEXT(aName) PWDebugTextOptionLoad (&(aName))
+
+
+#define DEBUG_DECLARE_COUNTER(aName) __attribute__((visibility("default"))) \
+extern PWDebugCounter aName; \
+enum { aName ## _DECLARE_Missing = 0 };
+
+#define DEBUG_DEFINE_COUNTER(aName, targetGroup, aTitle, aToolTip) \
+enum { aName ## Dummy = aName ## _DECLARE_Missing }; \
+PWDebugCounter aName; \
+@implementation targetGroup (aName) \
+- (void) createOption##aName { \
+    [self addOption: \
+     [[PWDebugCounterOption alloc] initWithTitle:aTitle toolTip:aToolTip counter:&aName] \
+        withPropertyName:@#aName]; \
+} \
+@end
+
+#define DEBUG_COUNTER(aName, targetGroup, aTitle, aToolTip) \
+static PWDebugCounter aName; \
+@implementation targetGroup (aName) \
+- (void) createOption##aName { \
+    [self addOption: \
+     [[PWDebugCounterOption alloc] initWithTitle:aTitle toolTip:aToolTip counter:&aName] \
+        withPropertyName:@#aName]; \
+} \
+@end
+
+#define DEBUG_COUNTER_ADD(aName, delta) PWDebugCounterAdd (&aName, (delta))
+
+#define DEBUG_COUNTER_INCREMENT(aName) PWDebugCounterAdd (&aName, 1)
+
 
 #define DEBUG_OPTION_ACTIONBLOCK(aName, targetGroup, aTitle, aToolTip, block) \
 @implementation targetGroup (aName) \
@@ -273,6 +506,23 @@ static NSString* aName; \
 @end
 
 
+#define DEBUG_OPTION_ASYNC_ACTIONBLOCK(aName, targetGroup, aTitle, aToolTip, block) \
+@implementation targetGroup (aName) \
+- (void) createOption##aName { \
+    [self addOption: \
+     [[PWDebugAsyncActionBlockOption alloc] initWithTitle:aTitle toolTip:aToolTip queue:nil actionBlock:block]]; \
+} \
+@end
+
+#define DEBUG_OPTION_ASYNC_ACTIONBLOCK_WITHQUEUE(aName, targetGroup, aTitle, aToolTip, aQueue, block) \
+@implementation targetGroup (aName) \
+- (void) createOption##aName { \
+    [self addOption: \
+     [[PWDebugAsyncActionBlockOption alloc] initWithTitle:aTitle toolTip:aToolTip queue:aQueue actionBlock:block]]; \
+} \
+@end
+
+
 #define DEBUG_NAMED_OBSERVABLE_REGISTRATION(aName, anObservable, aKeyPath) \
 @implementation PWDebugNamedObservables (aName) \
 + (id) observableFor##aName { return anObservable; } \
@@ -321,6 +571,39 @@ static NSString* aName; \
 #define DEBUG_OPTION_ENUM_D(aName, targetGroup, aTitle, aToolTip, aFlag, aType, aDefaultValue, isPersistent, ...) \
         DEBUG_OPTION_ENUM  (aName, targetGroup, aTitle, aToolTip, aFlag, aType, aDefaultValue, isPersistent, __VA_ARGS__)
 
+#define DEBUG_OPTION_READ_D(aName) \
+        DEBUG_OPTION_READ  (aName)
+
+#define DEBUG_OPTION_ACTIVE_D(aName) \
+        DEBUG_OPTION_ACTIVE  (aName)
+
+#define DEBUG_OPTION_DECLARE_EXPIRY_D(aName) \
+        DEBUG_OPTION_DECLARE_EXPIRY  (aName)
+
+#define DEBUG_OPTION_DEFINE_EXPIRY_D(aName, targetGroup, aSeconds, anEvaluationCount) \
+        DEBUG_OPTION_DEFINE_EXPIRY  (aName, targetGroup, aSeconds, anEvaluationCount)
+
+#define DEBUG_OPTION_EXPIRY_D(aName, targetGroup, aSeconds, anEvaluationCount) \
+        DEBUG_OPTION_EXPIRY  (aName, targetGroup, aSeconds, anEvaluationCount)
+
+#define DEBUG_OPTION_EVALUATE_D(aName) \
+        DEBUG_OPTION_EVALUATE  (aName)
+
+#define DEBUG_OPTION_DECLARE_CPU_BUDGET_D(aName) \
+        DEBUG_OPTION_DECLARE_CPU_BUDGET  (aName)
+
+#define DEBUG_OPTION_DEFINE_CPU_BUDGET_D(aName, targetGroup, aFraction, aWindow) \
+        DEBUG_OPTION_DEFINE_CPU_BUDGET  (aName, targetGroup, aFraction, aWindow)
+
+#define DEBUG_OPTION_CPU_BUDGET_D(aName, targetGroup, aFraction, aWindow) \
+        DEBUG_OPTION_CPU_BUDGET  (aName, targetGroup, aFraction, aWindow)
+
+#define DEBUG_OPTION_GROUP_CPU_BUDGET_D(aGroup, aFraction, aWindow) \
+        DEBUG_OPTION_GROUP_CPU_BUDGET  (aGroup, aFraction, aWindow)
+
+#define DEBUG_OPTION_MEASURE_CPU_D(aName) \
+        DEBUG_OPTION_MEASURE_CPU  (aName)
+
 #define DEBUG_OPTION_DECLARE_TEXT_D(aName) \
         DEBUG_OPTION_DECLARE_TEXT  (aName)
 
@@ -330,9 +613,33 @@ static NSString* aName; \
 #define DEBUG_OPTION_TEXT_D(aName, targetGroup, aTitle, aToolTip, isPersistent) \
         DEBUG_OPTION_TEXT  (aName, targetGroup, aTitle, aToolTip, isPersistent)
 
+#define DEBUG_OPTION_READ_TEXT_D(aName) \
+        DEBUG_OPTION_READ_TEXT  (aName)
+
+#define DEBUG_DECLARE_COUNTER_D(aName) \
+        DEBUG_DECLARE_COUNTER  (aName)
+
+#define DEBUG_DEFINE_COUNTER_D(aName, targetGroup, aTitle, aToolTip) \
+        DEBUG_DEFINE_COUNTER  (aName, targetGroup, aTitle, aToolTip)
+
+#define DEBUG_COUNTER_D(aName, targetGroup, aTitle, aToolTip) \
+        DEBUG_COUNTER  (aName, targetGroup, aTitle, aToolTip)
+
+#define DEBUG_COUNTER_ADD_D(aName, delta) \
+        DEBUG_COUNTER_ADD  (aName, delta)
+
+#define DEBUG_COUNTER_INCREMENT_D(aName) \
+        DEBUG_COUNTER_INCREMENT  (aName)
+
 #define DEBUG_OPTION_ACTIONBLOCK_D(aName, targetGroup, aTitle, aToolTip, block) \
         DEBUG_OPTION_ACTIONBLOCK  (aName, targetGroup, aTitle, aToolTip, block)
 
+#define DEBUG_OPTION_ASYNC_ACTIONBLOCK_D(aName, targetGroup, aTitle, aToolTip, block) \
+        DEBUG_OPTION_ASYNC_ACTIONBLOCK  (aName, targetGroup, aTitle, aToolTip, block)
+
+#define DEBUG_OPTION_ASYNC_ACTIONBLOCK_WITHQUEUE_D(aName, targetGroup, aTitle, aToolTip, aQueue, block) \
+        DEBUG_OPTION_ASYNC_ACTIONBLOCK_WITHQUEUE  (aName, targetGroup, aTitle, aToolTip, aQueue, block)
+
 #define DEBUG_NAMED_OBSERVABLE_REGISTRATION_D(aName, anObservable, aKeyPath) \
         DEBUG_NAMED_OBSERVABLE_REGISTRATION  (aName, anObservable, aKeyPath)
 
@@ -353,11 +660,34 @@ static NSString* aName; \
 #define DEBUG_OPTION_DEFINE_ENUM_D(aName, targetGroup, aTitle, aToolTip, aFlag, aType, aDefaultValue, isPersistent, ...)
 #define DEBUG_OPTION_ENUM_D(aName, targetGroup, aTitle, aToolTip, aFlag, aType, aDefaultValue, isPersistent, ...) enum:aType { aName = aDefaultValue };
 
+#define DEBUG_OPTION_READ_D(aName) (aName)
+#define DEBUG_OPTION_ACTIVE_D(aName) (aName)
+
+#define DEBUG_OPTION_DECLARE_EXPIRY_D(aName)
+#define DEBUG_OPTION_DEFINE_EXPIRY_D(aName, targetGroup, aSeconds, anEvaluationCount)
+#define DEBUG_OPTION_EXPIRY_D(aName, targetGroup, aSeconds, anEvaluationCount)
+#define DEBUG_OPTION_EVALUATE_D(aName) (aName)
+
+#define DEBUG_OPTION_DECLARE_CPU_BUDGET_D(aName)
+#define DEBUG_OPTION_DEFINE_CPU_BUDGET_D(aName, targetGroup, aFraction, aWindow)
+#define DEBUG_OPTION_CPU_BUDGET_D(aName, targetGroup, aFraction, aWindow)
+#define DEBUG_OPTION_GROUP_CPU_BUDGET_D(aGroup, aFraction, aWindow)
+#define DEBUG_OPTION_MEASURE_CPU_D(aName) ((void)0)
+
 #define DEBUG_OPTION_DECLARE_TEXT_D(aName) enum { aName = 0 };
 #define DEBUG_OPTION_DEFINE_TEXT_D(aName, targetGroup, aTitle, aToolTip, isPersistent)
 #define DEBUG_OPTION_TEXT_D(aName, targetGroup, aTitle, aToolTip, isPersistent) enum { aName = 0 };
+#define DEBUG_OPTION_READ_TEXT_D(aName) ((NSString*)nil)
+
+#define DEBUG_DECLARE_COUNTER_D(aName)
+#define DEBUG_DEFINE_COUNTER_D(aName, targetGroup, aTitle, aToolTip)
+#define DEBUG_COUNTER_D(aName, targetGroup, aTitle, aToolTip)
+#define DEBUG_COUNTER_ADD_D(aName, delta) ((void)0)
+#define DEBUG_COUNTER_INCREMENT_D(aName) ((void)0)
 
 #define DEBUG_OPTION_ACTIONBLOCK_D(aName, targetGroup, aTitle, aToolTip, block)
+#define DEBUG_OPTION_ASYNC_ACTIONBLOCK_D(aName, targetGroup, aTitle, aToolTip, block)
+#define DEBUG_OPTION_ASYNC_ACTIONBLOCK_WITHQUEUE_D(aName, targetGroup, aTitle, aToolTip, aQueue, block)
 
 #define DEBUG_NAMED_OBSERVABLE_REGISTRATION_D(aName, anObservable, aKeyPath)
 
@@ -0,0 +1,58 @@
+//
+//  PWDebugOptionSearchIndex.h
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class PWDebugOption;
+@class PWDebugOptionGroup;
+
+
+/// One option found by PWDebugOptionSearchIndex.
+@interface PWDebugOptionSearchResult : NSObject
+
+- (instancetype) init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly, strong)     PWDebugOption*          option;
+
+/// The group containing 'option'.
+@property (nonatomic, readonly, weak)       PWDebugOptionGroup*     group;
+
+/// Titles of the sub groups leading from the root group to 'group'. Empty for options of the root group.
+@property (nonatomic, readonly, copy)       NSArray<NSString*>*     path;
+
+@end
+
+#pragma mark -
+
+/// Search index over the titles, tool tips and group paths of all options in a tree of option groups.
+/// The index is built once and updated incrementally when options are added to groups of the tree. Options added on
+/// other threads are indexed asynchronously on the main queue. Not thread safe, use from the main thread only.
+@interface PWDebugOptionSearchIndex : NSObject
+
+- (instancetype) initWithRootGroup:(PWDebugOptionGroup*)rootGroup NS_DESIGNATED_INITIALIZER;
+- (instancetype) init NS_UNAVAILABLE;
+
+/// The index for 'rootGroup', created on first use.
++ (PWDebugOptionSearchIndex*) searchIndexForRootGroup:(PWDebugOptionGroup*)rootGroup;
+
+/// Number of indexed options.
+@property (nonatomic, readonly) NSUInteger  count;
+
+/// Options matching all words in 'query', in the current tree order, also for options added after the index was built.
+/// Matching ignores case and diacritics. Words with at least three characters match anywhere inside a word, shorter
+/// ones match the beginning of words.
+- (NSArray<PWDebugOptionSearchResult*>*) resultsForQuery:(NSString*)query;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,313 @@
+//
+//  PWDebugOptionSearchIndex.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import "PWDebugOptionSearchIndex.h"
+#import "PWDebugOptions.h"
+#import "PWDebugOptionGroup.h"
+#import <objc/runtime.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Query words up to this length are matched against word prefixes, longer ones against trigrams.
+static const NSUInteger PWShortWordLength = 2;
+
+@interface PWDebugOptionSearchResult ()
+
+- (instancetype) initWithOption:(PWDebugOption*)option
+                          group:(PWDebugOptionGroup*)group
+                           path:(NSArray<NSString*>*)path
+                       haystack:(NSString*)haystack NS_DESIGNATED_INITIALIZER;
+
+/// Normalized title, tool tip and path, used to verify trigram matches.
+@property (nonatomic, readonly, copy)       NSString*               haystack;
+
+@end
+
+#pragma mark -
+
+@implementation PWDebugOptionSearchIndex
+{
+    NSMutableArray<PWDebugOptionSearchResult*>*                 _entries;
+    NSMutableDictionary<NSString*, NSMutableIndexSet*>*         _prefixes;
+    NSMutableDictionary<NSString*, NSMutableIndexSet*>*         _trigrams;
+    NSMapTable<PWDebugOptionGroup*, NSArray<NSString*>*>*       _pathsByGroup;
+    NSHashTable<PWDebugOption*>*                                _indexedOptions;
+    NSMapTable<PWDebugOption*, NSNumber*>*                      _treePositions;     // nil after a change of the tree
+    __weak PWDebugOptionGroup*                                  _rootGroup;
+}
+
+- (instancetype) initWithRootGroup:(PWDebugOptionGroup*)rootGroup
+{
+    NSParameterAssert (rootGroup);
+
+    self = [super init];
+    _entries      = [[NSMutableArray alloc] init];
+    _prefixes     = [[NSMutableDictionary alloc] init];
+    _trigrams     = [[NSMutableDictionary alloc] init];
+    _pathsByGroup = [NSMapTable weakToStrongObjectsMapTable];
+    _indexedOptions = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality];
+    _rootGroup    = rootGroup;
+
+    [self indexGroup:rootGroup path:@[]];
+
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector (groupDidAddOption:)
+                                               name:PWDebugOptionGroupDidAddOptionNotification
+                                             object:nil];
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector (groupDidSortOptions:)
+                                               name:PWDebugOptionGroupDidSortOptionsNotification
+                                             object:nil];
+    return self;
+}
+
+- (void) dealloc
+{
+    [NSNotificationCenter.defaultCenter removeObserver:self];
+}
+
++ (PWDebugOptionSearchIndex*) searchIndexForRootGroup:(PWDebugOptionGroup*)rootGroup
+{
+    NSParameterAssert (rootGroup);
+
+    static char sSearchIndexKey;
+    PWDebugOptionSearchIndex* index = objc_getAssociatedObject (rootGroup, &sSearchIndexKey);
+    if (!index) {
+        index = [[self alloc] initWithRootGroup:rootGroup];
+        objc_setAssociatedObject (rootGroup, &sSearchIndexKey, index, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    return index;
+}
+
+- (NSUInteger) count
+{
+    return _entries.count;
+}
+
+#pragma mark - Querying
+
+- (NSArray<PWDebugOptionSearchResult*>*) resultsForQuery:(NSString*)query
+{
+    NSParameterAssert (query);
+
+    NSArray<NSString*>* words = [self.class wordsInNormalizedString:[self.class normalizedString:query]];
+    if (words.count == 0)
+        return @[];
+
+    // Intersect the matches of all words.
+    NSMutableIndexSet* candidates = nil;
+    for (NSString* iWord in words) {
+        NSIndexSet* iMatches = [self matchesForWord:iWord];
+        if (!candidates)
+            candidates = [iMatches mutableCopy];
+        else
+            [candidates removeIndexes:[candidates indexesPassingTest:^BOOL (NSUInteger idx, BOOL* stop) {
+                return ![iMatches containsIndex:idx];
+            }]];
+        if (candidates.count == 0)
+            return @[];
+    }
+
+    NSMutableArray<PWDebugOptionSearchResult*>* results = [[NSMutableArray alloc] initWithCapacity:candidates.count];
+    [candidates enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL* stop) {
+        [results addObject:self->_entries[idx]];
+    }];
+
+    // Entries are in registration order, which differs from tree order once options are added to groups after the
+    // index was built, or groups are sorted.
+    if (results.count > 1) {
+        NSMapTable<PWDebugOption*, NSNumber*>* positions = self.treePositions;
+        [results sortWithOptions:NSSortStable usingComparator:^NSComparisonResult (PWDebugOptionSearchResult* result1,
+                                                                                    PWDebugOptionSearchResult* result2) {
+            NSUInteger position1 = [[positions objectForKey:result1.option] unsignedIntegerValue];
+            NSUInteger position2 = [[positions objectForKey:result2.option] unsignedIntegerValue];
+            return (position1 < position2) ? NSOrderedAscending
+                 : (position1 > position2) ? NSOrderedDescending : NSOrderedSame;
+        }];
+    }
+    return results;
+}
+
+// Numbering the tree is linear in its size, therefore it is done once per change of the tree, not once per query.
+- (NSMapTable<PWDebugOption*, NSNumber*>*) treePositions
+{
+    if (!_treePositions) {
+        _treePositions = [NSMapTable strongToStrongObjectsMapTable];
+        PWDebugOptionGroup* rootGroup = _rootGroup;
+        if (rootGroup)
+            [self.class addTreePositionsOfGroup:rootGroup to:_treePositions];
+    }
+    return _treePositions;
+}
+
+/// Numbers the options depth first, each sub group option followed by the options of its sub group.
++ (void) addTreePositionsOfGroup:(PWDebugOptionGroup*)group to:(NSMapTable<PWDebugOption*, NSNumber*>*)positions
+{
+    for (PWDebugOption* iOption in group.options) {
+        [positions setObject:@(positions.count) forKey:iOption];
+        if ([iOption isKindOfClass:PWDebugOptionSubGroup.class])
+            [self addTreePositionsOfGroup:((PWDebugOptionSubGroup*)iOption).subGroup to:positions];
+    }
+}
+
+- (NSIndexSet*) matchesForWord:(NSString*)word
+{
+    NSParameterAssert (word.length > 0);
+
+    if (word.length <= PWShortWordLength) {
+        NSIndexSet* matches = _prefixes[word];
+        return matches ? matches : [NSIndexSet indexSet];
+    }
+
+    // Intersect the entries of all trigrams of the word, starting with the rarest one.
+    NSMutableArray<NSIndexSet*>* trigramMatches = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i + 3 <= word.length; ++i) {
+        NSIndexSet* iMatches = _trigrams[[word substringWithRange:NSMakeRange (i, 3)]];
+        if (!iMatches)
+            return [NSIndexSet indexSet];
+        [trigramMatches addObject:iMatches];
+    }
+    [trigramMatches sortUsingComparator:^NSComparisonResult (NSIndexSet* set1, NSIndexSet* set2) {
+        return (set1.count < set2.count) ? NSOrderedAscending
+             : (set1.count > set2.count) ? NSOrderedDescending : NSOrderedSame;
+    }];
+
+    NSIndexSet* rarest = trigramMatches.firstObject;
+    return [rarest indexesPassingTest:^BOOL (NSUInteger idx, BOOL* stop) {
+        for (NSIndexSet* iMatches in trigramMatches)
+            if (![iMatches containsIndex:idx])
+                return NO;
+        // Trigrams may come from different words, so verify the candidate.
+        return [self->_entries[idx].haystack rangeOfString:word].location != NSNotFound;
+    }];
+}
+
+#pragma mark - Indexing
+
+- (void) indexGroup:(PWDebugOptionGroup*)group path:(NSArray<NSString*>*)path
+{
+    [_pathsByGroup setObject:path forKey:group];
+    for (PWDebugOption* iOption in group.options)
+        [self indexOption:iOption inGroup:group path:path];
+}
+
+- (void) indexOption:(PWDebugOption*)option inGroup:(PWDebugOptionGroup*)group path:(NSArray<NSString*>*)path
+{
+    // An option added on another thread may already be indexed with its group when its notification arrives.
+    if ([_indexedOptions containsObject:option])
+        return;
+    [_indexedOptions addObject:option];
+
+    NSMutableArray<NSString*>* texts = [[NSMutableArray alloc] initWithObjects:option.title, nil];
+    if (option.toolTip)
+        [texts addObject:option.toolTip];
+    [texts addObjectsFromArray:path];
+    NSString* haystack = [self.class normalizedString:[texts componentsJoinedByString:@"\n"]];
+
+    NSUInteger entryIndex = _entries.count;
+    [_entries addObject:[[PWDebugOptionSearchResult alloc] initWithOption:option group:group path:path haystack:haystack]];
+
+    for (NSString* iWord in [self.class wordsInNormalizedString:haystack]) {
+        for (NSUInteger i = 1; i <= MIN (iWord.length, PWShortWordLength); ++i)
+            [self addEntryIndex:entryIndex forKey:[iWord substringToIndex:i] inTable:_prefixes];
+        for (NSUInteger i = 0; i + 3 <= iWord.length; ++i)
+            [self addEntryIndex:entryIndex forKey:[iWord substringWithRange:NSMakeRange (i, 3)] inTable:_trigrams];
+    }
+
+    if ([option isKindOfClass:PWDebugOptionSubGroup.class])
+        [self indexGroup:((PWDebugOptionSubGroup*)option).subGroup path:[path arrayByAddingObject:option.title]];
+}
+
+- (void) addEntryIndex:(NSUInteger)entryIndex
+                forKey:(NSString*)key
+               inTable:(NSMutableDictionary<NSString*, NSMutableIndexSet*>*)table
+{
+    NSMutableIndexSet* entries = table[key];
+    if (!entries) {
+        entries = [[NSMutableIndexSet alloc] init];
+        table[key] = entries;
+    }
+    [entries addIndex:entryIndex];
+}
+
+- (void) groupDidAddOption:(NSNotification*)notification
+{
+    // Groups post on the thread which added the option, the index is used from the main thread only.
+    if (!NSThread.isMainThread) {
+        dispatch_async (dispatch_get_main_queue (), ^{
+            [self groupDidAddOption:notification];
+        });
+        return;
+    }
+
+    PWDebugOptionGroup* group = notification.object;
+    NSArray<NSString*>* path = [_pathsByGroup objectForKey:group];
+    if (!path)
+        return;     // group is not part of this tree
+
+    PWDebugOption* option = notification.userInfo[PWDebugOptionGroupAddedOptionKey];
+    NSAssert (option, @"option missing in notification");
+    [self indexOption:option inGroup:group path:path];
+    _treePositions = nil;
+}
+
+- (void) groupDidSortOptions:(NSNotification*)notification
+{
+    if (!NSThread.isMainThread) {
+        dispatch_async (dispatch_get_main_queue (), ^{
+            [self groupDidSortOptions:notification];
+        });
+        return;
+    }
+
+    if ([_pathsByGroup objectForKey:notification.object])
+        _treePositions = nil;   // group is part of this tree
+}
+
++ (NSString*) normalizedString:(NSString*)string
+{
+    return [string stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch locale:nil];
+}
+
++ (NSArray<NSString*>*) wordsInNormalizedString:(NSString*)string
+{
+    NSArray<NSString*>* components = [string componentsSeparatedByCharactersInSet:
+                                      NSCharacterSet.alphanumericCharacterSet.invertedSet];
+    return [components filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"length > 0"]];
+}
+
+@end
+
+#pragma mark -
+
+@implementation PWDebugOptionSearchResult
+
+- (instancetype) initWithOption:(PWDebugOption*)option
+                          group:(PWDebugOptionGroup*)group
+                           path:(NSArray<NSString*>*)path
+                       haystack:(NSString*)haystack
+{
+    NSParameterAssert (option);
+    NSParameterAssert (group);
+    NSParameterAssert (path);
+    NSParameterAssert (haystack);
+
+    self = [super init];
+    _option   = option;
+    _group    = group;
+    _path     = [path copy];
+    _haystack = [haystack copy];
+    return self;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,44 @@
+//
+//  PWDebugOptionStore.h
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Persistence backend for the state of debug options and groups. Values are NSNumber or NSString objects.
+/// NSUserDefaults is the default backend, PWDebugOptionFileStore an alternative for headless processes and Linux.
+@protocol PWDebugOptionStore <NSObject>
+
+- (nullable id) objectForKey:(NSString*)key;
+
+/// Passing nil removes the value.
+- (void) setObject:(nullable id)value forKey:(NSString*)key;
+
+- (void) removeObjectForKey:(NSString*)key;
+
+/// Make all changes durable.
+- (BOOL) synchronize;
+
+/// A separate store for the groups which share their state under 'suiteName', e.g. the members of an app group.
+- (id<PWDebugOptionStore>) storeForSuiteName:(NSString*)suiteName;
+
+@end
+
+#pragma mark -
+
+@interface NSUserDefaults (PWDebugOptionStore) <PWDebugOptionStore>
+
+/// A user defaults suite.
+- (id<PWDebugOptionStore>) storeForSuiteName:(NSString*)suiteName;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,26 @@
+//
+//  PWDebugOptionStore.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import "PWDebugOptionStore.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@implementation NSUserDefaults (PWDebugOptionStore)
+
+- (id<PWDebugOptionStore>) storeForSuiteName:(NSString*)suiteName
+{
+    NSParameterAssert (suiteName);
+    return [[NSUserDefaults alloc] initWithSuiteName:suiteName];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -10,6 +10,10 @@
 //
 
 #import <Foundation/Foundation.h>
+#import <dispatch/dispatch.h>
+#import <stdatomic.h>
+#import <time.h>
+#import <DebugOptionsFoundation/PWDebugOptionStore.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -17,9 +21,131 @@ NS_ASSUME_NONNULL_BEGIN
 
 typedef void (^PWDebugActionBlock) (void);
 
+/// Block of an asynchronous action. 'progress' serves both as progress reporter (set totalUnitCount and
+/// completedUnitCount) and as cancellation token (check progress.cancelled regularly).
+typedef void (^PWDebugAsyncActionBlock) (NSProgress* progress);
+
+/// Monotonic time stamp in nanoseconds, used to measure durations.
+NS_INLINE uint64_t PWDebugMonotonicNanoseconds (void)
+{
+#ifdef __APPLE__
+    return clock_gettime_nsec_np (CLOCK_UPTIME_RAW);
+#else
+    struct timespec time;
+    clock_gettime (CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * NSEC_PER_SEC + (uint64_t)time.tv_nsec;
+#endif
+}
+
+#pragma mark - Debug counters
+
+#if defined (__APPLE__) && defined (__arm64__)
+#define PW_DEBUG_CACHE_LINE_SIZE 128
+#else
+#define PW_DEBUG_CACHE_LINE_SIZE 64
+#endif
+
+/// Attribute for the target variables of switches and enumerations. Places all targets in one dedicated read-mostly
+/// section, each aligned to a cache line, so that no frequently written data shares a cache line with them.
+/// The isolation is partial: alignment pads in front of each target, not behind it, and the linker does not pad the
+/// end of the section. The line of the last target may therefore be shared with whatever the linker places next.
+#ifdef __APPLE__
+#define PW_DEBUG_OPTION_STORAGE __attribute__((section ("__DATA,__pw_debug_opts"), aligned (PW_DEBUG_CACHE_LINE_SIZE)))
+#else
+#define PW_DEBUG_OPTION_STORAGE __attribute__((section (".data.pw_debug_opts"), aligned (PW_DEBUG_CACHE_LINE_SIZE)))
+#endif
+
+/// Number of shards per counter. Threads are assigned to shards round-robin.
+#define PW_DEBUG_COUNTER_SHARD_COUNT 16
+
+/// One cache line per shard, so increments from different threads do not contend for the same line.
+typedef struct {
+    _Alignas (PW_DEBUG_CACHE_LINE_SIZE) _Atomic (int64_t) value;
+} PWDebugCounterShard;
+
+typedef struct {
+    PWDebugCounterShard shards[PW_DEBUG_COUNTER_SHARD_COUNT];
+} PWDebugCounter;
+
+/// One-based shard index of the current thread, 0 until the thread increments a counter for the first time.
+FOUNDATION_EXPORT _Thread_local unsigned PWDebugCounterThreadShard;
+
+FOUNDATION_EXPORT unsigned PWDebugCounterAssignThreadShard (void);
+
+NS_INLINE void PWDebugCounterAdd (PWDebugCounter* counter, int64_t delta)
+{
+    unsigned shard = PWDebugCounterThreadShard;
+    if (shard == 0)
+        shard = PWDebugCounterAssignThreadShard ();
+    atomic_fetch_add_explicit (&counter->shards[shard - 1].value, delta, memory_order_relaxed);
+}
+
+/// Sum of all shards. Not a consistent snapshot while other threads are incrementing.
+FOUNDATION_EXPORT int64_t PWDebugCounterValue (PWDebugCounter* counter);
+
+/// Zeroes the shards one after the other. Not atomic with respect to concurrent increments, which may or may not be
+/// counted after the reset.
+FOUNDATION_EXPORT void PWDebugCounterReset (PWDebugCounter* counter);
+
+
+#pragma mark - Expiry
+
+/// Evaluation budget of an expiring option. Written on every evaluation, therefore padded to a whole cache line, so
+/// that no other data shares it.
+typedef struct {
+    _Alignas (PW_DEBUG_CACHE_LINE_SIZE) _Atomic (int64_t) value;
+} PWDebugEvaluationBudget;
+
+/// Called once by the evaluation which used up an evaluation budget.
+FOUNDATION_EXPORT void PWDebugOptionEvaluationBudgetExhausted (_Atomic (int64_t)* budget);
+
+/// Counts one evaluation against 'budget'. Does nothing unless the option owning the budget is expiring.
+NS_INLINE void PWDebugOptionConsumeEvaluation (_Atomic (int64_t)* budget)
+{
+    if (   atomic_load_explicit (budget, memory_order_relaxed) > 0
+        && atomic_fetch_sub_explicit (budget, 1, memory_order_relaxed) == 1)
+        PWDebugOptionEvaluationBudgetExhausted (budget);
+}
+
+
+#pragma mark - CPU budgets
+
+/// Measures one scope guarded by a switch. See DEBUG_OPTION_MEASURE_CPU.
+typedef struct {
+    PWDebugCounter* counter;
+    uint64_t        startTime;
+} PWDebugCPUScope;
+
+NS_INLINE PWDebugCPUScope PWDebugCPUScopeBegin (PWDebugCounter* counter)
+{
+    return (PWDebugCPUScope){ counter, PWDebugMonotonicNanoseconds () };
+}
+
+NS_INLINE void PWDebugCPUScopeEnd (PWDebugCPUScope* scope)
+{
+    PWDebugCounterAdd (scope->counter, (int64_t)(PWDebugMonotonicNanoseconds () - scope->startTime));
+}
+
+/// Limit for the time spent in scopes guarded by a switch.
+@interface PWDebugCPUBudgetPolicy : NSObject
+
+- (instancetype) initWithFraction:(double)fraction window:(NSTimeInterval)window NS_DESIGNATED_INITIALIZER;
+- (instancetype) init NS_UNAVAILABLE;
+
+/// Maximum share of wall time spent in guarded scopes, summed over all threads. May exceed 1 for multiple threads.
+@property (nonatomic, readonly)     double          fraction;
+
+/// Length of the sliding window over which the share is measured, in seconds.
+@property (nonatomic, readonly)     NSTimeInterval  window;
+
+@end
+
 
 #pragma mark -
 
+/// Posted after the value of an option changed, on the thread which changed it. Object is the option.
+extern NSNotificationName const PWDebugOptionDidChangeNotification;
+
 @interface PWDebugOption : NSObject
 
 - (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip NS_DESIGNATED_INITIALIZER;
@@ -32,12 +158,66 @@ typedef void (^PWDebugActionBlock) (void);
 @property (nonatomic, readwrite, nullable)          Class               groupClass;
 @property (nonatomic, readwrite, copy, nullable)    NSString*           propertyName;
 
+/// The group this option has been added to.
+@property (nonatomic, readwrite, weak, nullable)    PWDebugOptionGroup* group;
+
 /// currentValue from subclasses boxed as necessary.
 /// Note: currently unused.
 @property (nonatomic, readwrite, nullable)          id                  kvValue;
 
 // Base implementation does nothing.
-- (void) loadStateFromUserDefaults:(NSUserDefaults*)userDefaults;
+- (void) loadStateFromStore:(id<PWDebugOptionStore>)store;
+
+/// Store the value seen through DEBUG_OPTION_ACTIVE, which is masked if 'groupEnabled' is NO.
+/// Base implementation does nothing. Called by the group while it holds its effective state lock.
+- (void) updateActiveStateForGroupEnabled:(BOOL)groupEnabled;
+
+/// Recompute the active state after a change of the option value.
+- (void) updateActiveState;
+
+/// Post PWDebugOptionDidChangeNotification. For use by subclasses.
+- (void) postDidChangeNotification;
+
+/// Post the KVO and change notifications for a value changed through applyDefaultValue, asynchronously on the main
+/// queue. For use by subclasses.
+- (void) postChangeNotificationsOnMainQueue;
+
+/// Expiry policy, supported by switches and enumerations: once set to a value other than its default, the option
+/// reverts to the default after 'interval' seconds or after 'evaluationCount' evaluations through
+/// DEBUG_OPTION_EVALUATE, whichever comes first. Pass 0 to disable either limit. 'evaluationBudget' is counted down
+/// by DEBUG_OPTION_EVALUATE and is required if 'evaluationCount' is not 0.
+/// The value reverts on the queue of the shared timer wheel, also in processes without a main run loop. The normal
+/// change notifications follow on the main queue. A temporary value is never saved.
+- (void) setExpiryInterval:(NSTimeInterval)interval
+           evaluationCount:(int64_t)evaluationCount
+          evaluationBudget:(nullable _Atomic (int64_t)*)evaluationBudget;
+
+@property (nonatomic, readonly)                     NSTimeInterval      expiryInterval;
+@property (nonatomic, readonly)                     int64_t             expiryEvaluationCount;
+
+/// YES while the option holds a temporary value which is going to revert.
+@property (nonatomic, readonly)                     BOOL                isExpiring;
+
+/// Seconds until the option reverts, 0 if it does not expire by time.
+@property (nonatomic, readonly)                     NSTimeInterval      remainingExpiryInterval;
+
+/// Evaluations left until the option reverts, 0 if it does not expire by evaluations.
+@property (nonatomic, readonly)                     int64_t             remainingExpiryEvaluations;
+
+/// Revert the option to its default value now.
+- (void) expire;
+
+/// YES if the option holds its default value. Base implementation returns YES.
+@property (nonatomic, readonly)                     BOOL                hasDefaultValue;
+
+/// Base implementation does nothing.
+- (void) revertToDefaultValue;
+
+/// Like revertToDefaultValue, but without posting notifications. Base implementation does nothing.
+- (void) applyDefaultValue;
+
+/// Arm or disarm the expiry policy after a change of the option value. For use by subclasses.
+- (void) updateExpiry;
 
 + (NSString*) defaultsKeyForDebugOptionName:(NSString*)name;
 
@@ -68,16 +248,46 @@ typedef void (^PWDebugActionBlock) (void);
 - (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip NS_UNAVAILABLE;
 
 @property (nonatomic, readonly)                     _Atomic (BOOL)* target;
+@property (nonatomic, readonly)                     BOOL            defaultValue;
 @property (nonatomic, readwrite)                    BOOL            currentValue;
 
+/// If set, receives currentValue while the group is effectively enabled, NO otherwise.
+@property (nonatomic, readwrite, nullable)          _Atomic (BOOL)* activeTarget;
+
 @property (nonatomic, readonly, copy,   nullable)   NSString*       defaultsKey;
-@property (nonatomic, readonly, strong, nullable)   NSUserDefaults* userDefaults;
+@property (nonatomic, readonly, strong, nullable)   id<PWDebugOptionStore> store;
 
-// Save current value in user defaults
+// Save current value in the store
 - (void) saveState;
 
+/// Counts the nanoseconds spent in scopes guarded by this switch. Set with -setCPUTimeCounter:policy:.
+@property (nonatomic, readonly, nullable)           PWDebugCounter*             cpuTimeCounter;
+
+/// Policy of this switch. If nil, the policy of the group or its nearest ancestor with a policy applies.
+@property (atomic, readwrite, strong, nullable)     PWDebugCPUBudgetPolicy*     cpuBudgetPolicy;
+
+@property (nonatomic, readonly, nullable)           PWDebugCPUBudgetPolicy*     effectiveCPUBudgetPolicy;
+
+/// Share of wall time spent in guarded scopes over the sampled part of the current window, 0 while off.
+@property (nonatomic, readonly)                     double                      cpuLoad;
+
+/// While the switch is on, the time in guarded scopes is sampled regularly on the queue of the shared timer wheel. If
+/// it exceeds the effective policy, the switch is turned off right there, which is logged and announced with
+/// PWDebugOptionCPUBudgetExceededNotification.
+- (void) setCPUTimeCounter:(PWDebugCounter*)counter policy:(nullable PWDebugCPUBudgetPolicy*)policy;
+
+/// Restart sampling with the current effective policy. Called by groups after their policy changed.
+- (void) updateCPUBudgetMonitor;
+
 @end
 
+/// Posted on the main queue after a switch was turned off for exceeding its CPU budget. Object is the option.
+/// Processes without a main run loop see the switch turned off, but not the notification.
+extern NSNotificationName const PWDebugOptionCPUBudgetExceededNotification;
+
+/// NSNumber with the measured share of wall time, in the user info of PWDebugOptionCPUBudgetExceededNotification.
+extern NSString* const PWDebugOptionCPULoadKey;
+
 #pragma mark -
 
 @interface PWDebugEnumOption : PWDebugOption
@@ -96,18 +306,26 @@ typedef void (^PWDebugActionBlock) (void);
 @property (nonatomic, readonly, copy)               NSArray<NSNumber*>*     values;
 @property (nonatomic, readonly, copy)               NSArray<NSString*>*     titles;
 
+@property (nonatomic, readonly)                     NSInteger               defaultValue;
 @property (nonatomic, readwrite)                    NSInteger               currentValue;
 
+/// If set, receives currentValue while the group is effectively enabled, defaultValue otherwise.
+@property (nonatomic, readwrite, nullable)          _Atomic (NSInteger)*    activeTarget;
+
 @property (nonatomic, readonly, copy, nullable)     NSString*               defaultsKey;
-@property (nonatomic, readonly, strong, nullable)   NSUserDefaults*         userDefaults;
+@property (nonatomic, readonly, strong, nullable)   id<PWDebugOptionStore>  store;
 
-// Save current value in user defaults
+// Save current value in the store
 - (void) saveState;
 
 @end
 
 #pragma mark -
 
+/// Text targets are strong object pointers, which must not be read while another thread replaces them. Read them
+/// through this function (or DEBUG_OPTION_READ_TEXT) unless all accesses happen on one thread.
+FOUNDATION_EXPORT NSString*_Nullable PWDebugTextOptionLoad (__strong NSString*_Nullable *_Nonnull target);
+
 @interface PWDebugTextOption : PWDebugOption
 
 - (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip
@@ -121,9 +339,9 @@ typedef void (^PWDebugActionBlock) (void);
 @property (nonatomic, readwrite, copy, nullable)    NSString*                               currentValue;
 
 @property (nonatomic, readonly,  copy, nullable)    NSString*                               defaultsKey;
-@property (nonatomic, readonly, strong, nullable)   NSUserDefaults*                         userDefaults;
+@property (nonatomic, readonly, strong, nullable)   id<PWDebugOptionStore>                  store;
 
-// Save current value in user defaults
+// Save current value in the store
 - (void) saveState;
 
 @end
@@ -145,6 +363,58 @@ typedef void (^PWDebugActionBlock) (void);
 
 #pragma mark -
 
+@interface PWDebugCounterOption : PWDebugOption
+
+- (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip
+                       counter:(PWDebugCounter*)counter NS_DESIGNATED_INITIALIZER;
+
+- (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip NS_UNAVAILABLE;
+
+@property (nonatomic, readonly)     PWDebugCounter* counter;
+
+/// Sum over all shards of the counter.
+@property (nonatomic, readonly)     int64_t         value;
+
+- (void) reset;
+
+@end
+
+#pragma mark -
+
+/// Posted on the main queue when a PWDebugAsyncActionBlockOption starts or finishes running. Object is the option.
+extern NSNotificationName const PWDebugAsyncActionOptionRunningStateDidChangeNotification;
+
+@interface PWDebugAsyncActionBlockOption : PWDebugOption
+
+/// If 'queue' is nil, the block runs on the global queue with utility QoS.
+- (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip
+                         queue:(nullable dispatch_queue_t)queue
+                   actionBlock:(PWDebugAsyncActionBlock)block NS_DESIGNATED_INITIALIZER;
+
+- (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip NS_UNAVAILABLE;
+
+@property (nonatomic, readonly, copy)       PWDebugAsyncActionBlock block;
+@property (nonatomic, readonly, strong)     dispatch_queue_t        queue;
+
+/// YES from the start of -execute: until the block returned.
+@property (atomic, readonly)                BOOL                    isRunning;
+
+/// Progress of the current run, nil if not running.
+@property (atomic, readonly, nullable)      NSProgress*             progress;
+
+/// Duration of the last completed run in seconds, 0 if the action did not run yet.
+@property (atomic, readonly)                NSTimeInterval          lastExecutionDuration;
+
+/// Starts the block on 'queue'. Does nothing if the action is already running.
+- (void) execute:(nullable id)sender;
+
+/// Cancels the progress of the current run, if any. It’s up to the block to react to it.
+- (void) cancel;
+
+@end
+
+#pragma mark -
+
 @interface PWDebugActionWithNamedTargetOption : PWDebugOption
 
 - (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip
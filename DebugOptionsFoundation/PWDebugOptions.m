@@ -13,11 +13,27 @@
 
 #import "PWDebugOptions.h"
 #import "PWDebugOptionGroup.h"
+#import "PWDebugTimerWheel.h"
+#import "PWDebugLock.h"
 #import <stdarg.h>
+#import <stdatomic.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
+NSNotificationName const PWDebugOptionDidChangeNotification = @"PWDebugOptionDidChange";
+
+// Maps evaluation budgets to their options, for the rare case that a budget is used up. Protected by sBudgetsLock.
+static NSMapTable<id, PWDebugOption*>* sOptionsByBudget;
+
+static PWDebugLock sBudgetsLock = PW_DEBUG_LOCK_INIT;
+
 @implementation PWDebugOption
+{
+    PWDebugLock                 _expiryLock;
+    _Atomic (int64_t)* _Nullable _evaluationBudget;
+    PWDebugTimerWheelEntry*     _expiryEntry;           // protected by _expiryLock
+    BOOL                        _expiring;              // protected by _expiryLock
+}
 
 @dynamic kvValue;   // must be implemented by subclass
 
@@ -27,12 +43,45 @@ NS_ASSUME_NONNULL_BEGIN
     self = [super init];
     _title   = [title copy];
     _toolTip = [toolTip copy];
+    PWDebugLockInit (&_expiryLock);
     return self;
 }
 
-- (void) loadStateFromUserDefaults:(NSUserDefaults*)userDefaults
+- (void) dealloc
+{
+    PWDebugLockDestroy (&_expiryLock);
+}
+
+- (void) loadStateFromStore:(id<PWDebugOptionStore>)store
 {
-    NSParameterAssert (userDefaults);
+    NSParameterAssert (store);
+}
+
+- (void) updateActiveStateForGroupEnabled:(BOOL)groupEnabled
+{
+}
+
+- (void) updateActiveState
+{
+    PWDebugOptionGroup* group = self.group;
+    if (group)
+        [group updateActiveStateOfOption:self];
+    else
+        [self updateActiveStateForGroupEnabled:YES];
+}
+
+- (void) postDidChangeNotification
+{
+    [NSNotificationCenter.defaultCenter postNotificationName:PWDebugOptionDidChangeNotification object:self];
+}
+
+- (void) postChangeNotificationsOnMainQueue
+{
+    dispatch_async (dispatch_get_main_queue (), ^{
+        [self.groupClass willChangeValueForKey:self.propertyName];
+        [self.groupClass didChangeValueForKey:self.propertyName];
+        [self postDidChangeNotification];
+    });
 }
 
 + (NSString*) defaultsKeyForDebugOptionName:(NSString*)name
@@ -41,8 +90,153 @@ NS_ASSUME_NONNULL_BEGIN
     return [@"DebugOption_" stringByAppendingString:name];
 }
 
+#pragma mark - Expiry
+
+- (void) setExpiryInterval:(NSTimeInterval)interval
+           evaluationCount:(int64_t)evaluationCount
+          evaluationBudget:(nullable _Atomic (int64_t)*)evaluationBudget
+{
+    NSParameterAssert (interval >= 0.0);
+    NSParameterAssert (evaluationCount >= 0);
+    NSParameterAssert (evaluationCount == 0 || evaluationBudget);
+
+    _expiryInterval        = interval;
+    _expiryEvaluationCount = evaluationCount;
+    _evaluationBudget      = evaluationBudget;
+
+    if (evaluationBudget) {
+        PWDebugLockLock (&sBudgetsLock);
+        if (!sOptionsByBudget)
+            sOptionsByBudget = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality
+                                                         valueOptions:NSPointerFunctionsWeakMemory
+                                                             capacity:0];
+        [sOptionsByBudget setObject:self forKey:(__bridge id)(void*)evaluationBudget];
+        PWDebugLockUnlock (&sBudgetsLock);
+    }
+
+    // Loading from user defaults may already have set a value other than the default.
+    [self updateExpiry];
+}
+
+- (void) updateExpiry
+{
+    if (_expiryInterval <= 0.0 && _expiryEvaluationCount <= 0)
+        return;
+
+    BOOL expiring = !self.hasDefaultValue;
+
+    PWDebugLockLock (&_expiryLock);
+    // Any change of the value restarts the countdown.
+    PWDebugTimerWheelEntry* oldEntry = _expiryEntry;
+    _expiryEntry = nil;
+    if (expiring && _expiryInterval > 0.0) {
+        __weak PWDebugOption* weakSelf = self;
+        __block __weak PWDebugTimerWheelEntry* weakEntry;
+        PWDebugTimerWheelEntry* entry = [PWDebugTimerWheel.sharedWheel scheduleAfter:_expiryInterval handler:^{
+            [weakSelf expireEntry:weakEntry];
+        }];
+        weakEntry = entry;
+        _expiryEntry = entry;
+    }
+    if (_evaluationBudget)
+        atomic_store_explicit (_evaluationBudget, expiring ? _expiryEvaluationCount : 0, memory_order_relaxed);
+    _expiring = expiring;
+    PWDebugLockUnlock (&_expiryLock);
+
+    if (oldEntry)
+        [PWDebugTimerWheel.sharedWheel cancelEntry:oldEntry];
+}
+
+- (void) expireEntry:(nullable PWDebugTimerWheelEntry*)entry
+{
+    PWDebugLockLock (&_expiryLock);
+    BOOL isCurrent = entry && entry == _expiryEntry;
+    PWDebugLockUnlock (&_expiryLock);
+
+    if (isCurrent)
+        [self expireFromTimerWheel];
+}
+
+- (void) evaluationBudgetExhausted
+{
+    PWDebugLockLock (&_expiryLock);
+    BOOL exhausted = _expiring && atomic_load_explicit (_evaluationBudget, memory_order_relaxed) <= 0;
+    PWDebugLockUnlock (&_expiryLock);
+
+    if (exhausted)
+        [self expireFromTimerWheel];
+}
+
+- (BOOL) isExpiring
+{
+    PWDebugLockLock (&_expiryLock);
+    BOOL expiring = _expiring;
+    PWDebugLockUnlock (&_expiryLock);
+    return expiring;
+}
+
+- (NSTimeInterval) remainingExpiryInterval
+{
+    PWDebugLockLock (&_expiryLock);
+    NSTimeInterval remaining = _expiryEntry ? _expiryEntry.remainingTime : 0.0;
+    PWDebugLockUnlock (&_expiryLock);
+    return remaining;
+}
+
+- (int64_t) remainingExpiryEvaluations
+{
+    if (!_evaluationBudget || !self.isExpiring)
+        return 0;
+    return MAX (atomic_load_explicit (_evaluationBudget, memory_order_relaxed), 0);
+}
+
+- (void) expire
+{
+    if (self.isExpiring) {
+        NSLog (@"Debug option \"%@\" expired, reverting to its default value.", self.title);
+        [self revertToDefaultValue];
+    }
+}
+
+// Runs on the handler queue of the shared timer wheel, which works without a main run loop.
+- (void) expireFromTimerWheel
+{
+    if (self.isExpiring) {
+        NSLog (@"Debug option \"%@\" expired, reverting to its default value.", self.title);
+        [self applyDefaultValue];
+        [self postChangeNotificationsOnMainQueue];
+    }
+}
+
+- (BOOL) hasDefaultValue
+{
+    return YES;
+}
+
+- (void) revertToDefaultValue
+{
+}
+
+- (void) applyDefaultValue
+{
+}
+
 @end
 
+void PWDebugOptionEvaluationBudgetExhausted (_Atomic (int64_t)* budget)
+{
+    NSCParameterAssert (budget);
+
+    PWDebugLockLock (&sBudgetsLock);
+    PWDebugOption* option = [sOptionsByBudget objectForKey:(__bridge id)(void*)budget];
+    PWDebugLockUnlock (&sBudgetsLock);
+
+    // Called from the middle of arbitrary code, therefore revert later, like expiry by time.
+    dispatch_async (PWDebugTimerWheel.sharedWheel.handlerQueue, ^{
+        [option evaluationBudgetExhausted];
+    });
+}
+
 #pragma mark -
 
 @implementation PWDebugOptionSubGroup
@@ -58,17 +252,55 @@ NS_ASSUME_NONNULL_BEGIN
     return self;
 }
 
-- (void) loadStateFromUserDefaults:(NSUserDefaults*)userDefaults
+- (void) loadStateFromStore:(id<PWDebugOptionStore>)store
+{
+    NSParameterAssert (store);
+    [_subGroup loadStateFromStore:store];
+}
+
+@end
+
+#pragma mark -
+
+@implementation PWDebugCPUBudgetPolicy
+
+- (instancetype) initWithFraction:(double)fraction window:(NSTimeInterval)window
+{
+    NSParameterAssert (fraction > 0.0);
+    NSParameterAssert (window > 0.0);
+
+    self = [super init];
+    _fraction = fraction;
+    _window   = window;
+    return self;
+}
+
+- (NSString*) description
 {
-    NSParameterAssert (userDefaults);
-    [_subGroup loadStateFromUserDefaults:userDefaults];
+    return [NSString stringWithFormat:@"%.1f %% over %.1f s", _fraction * 100.0, _window];
 }
 
 @end
 
 #pragma mark -
 
+NSNotificationName const PWDebugOptionCPUBudgetExceededNotification = @"PWDebugOptionCPUBudgetExceeded";
+NSString* const PWDebugOptionCPULoadKey = @"cpuLoad";
+
+// A window is covered by this many samples, taken one slice of the window apart.
+#define PW_CPU_BUDGET_SLICES_PER_WINDOW 4
+
 @implementation PWDebugSwitchOption
+{
+    PWDebugLock                 _cpuBudgetLock;
+    PWDebugTimerWheelEntry*     _cpuSampleEntry;                                    // protected by _cpuBudgetLock
+    uint64_t                    _sampleTimes[PW_CPU_BUDGET_SLICES_PER_WINDOW + 1];  // protected by _cpuBudgetLock
+    int64_t                     _sampleValues[PW_CPU_BUDGET_SLICES_PER_WINDOW + 1]; // protected by _cpuBudgetLock
+    NSUInteger                  _sampleHead;                                        // protected by _cpuBudgetLock
+    NSUInteger                  _sampleCount;                                       // protected by _cpuBudgetLock
+    double                      _cpuLoad;                                           // protected by _cpuBudgetLock
+    NSUInteger                  _valueGeneration;                                   // protected by _cpuBudgetLock
+}
 
 - (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip
                  booleanTarget:(_Atomic (BOOL)*)target defaultValue:(BOOL)value
@@ -78,41 +310,101 @@ NS_ASSUME_NONNULL_BEGIN
     
     self = [super initWithTitle:title toolTip:toolTip];
     _target  = target;
-    *_target = value;
+    _defaultValue = value;
+    atomic_store_explicit (_target, value, memory_order_release);
     if (keySuffix)
         _defaultsKey = [self.class defaultsKeyForDebugOptionName:keySuffix];
+    PWDebugLockInit (&_cpuBudgetLock);
     return self;
 }
 
+- (void) dealloc
+{
+    PWDebugLockDestroy (&_cpuBudgetLock);
+}
+
 - (BOOL) currentValue
 {
-    return *_target;
+    return atomic_load_explicit (_target, memory_order_acquire);
 }
 
 - (void) setCurrentValue:(BOOL)value
 {
     [self.groupClass willChangeValueForKey:self.propertyName];
-    *_target = value;
+    [self applyCurrentValue:value];
     [self.groupClass didChangeValueForKey:self.propertyName];
+    [self postDidChangeNotification];
 }
 
-- (void) loadStateFromUserDefaults:(NSUserDefaults*)userDefaults
+- (void) applyCurrentValue:(BOOL)value
 {
-    NSParameterAssert (userDefaults);
+    [self storeCurrentValue:value];
+    [self updateActiveState];
+    [self updateExpiry];
+    [self updateCPUBudgetMonitor];
+}
+
+// Every store counts as a new generation, which tells a pending budget trip that the value changed meanwhile.
+- (void) storeCurrentValue:(BOOL)value
+{
+    PWDebugLockLock (&_cpuBudgetLock);
+    atomic_store_explicit (_target, value, memory_order_release);
+    ++_valueGeneration;
+    PWDebugLockUnlock (&_cpuBudgetLock);
+}
+
+- (BOOL) hasDefaultValue
+{
+    return self.currentValue == _defaultValue;
+}
+
+- (void) revertToDefaultValue
+{
+    self.currentValue = _defaultValue;
+}
+
+- (void) applyDefaultValue
+{
+    [self applyCurrentValue:_defaultValue];
+}
+
+- (void) setActiveTarget:(nullable _Atomic (BOOL)*)activeTarget
+{
+    _activeTarget = activeTarget;
+    [self updateActiveState];
+}
+
+- (void) updateActiveStateForGroupEnabled:(BOOL)groupEnabled
+{
+    if (_activeTarget)
+        atomic_store_explicit (_activeTarget, groupEnabled && self.currentValue, memory_order_release);
+}
+
+- (void) loadStateFromStore:(id<PWDebugOptionStore>)store
+{
+    NSParameterAssert (store);
 
     if (_defaultsKey) {
-        NSNumber* defaultValue = [userDefaults objectForKey:_defaultsKey];
-        if (defaultValue)
-            *_target = defaultValue.boolValue;
-        _userDefaults = userDefaults;
+        NSNumber* defaultValue = [store objectForKey:_defaultsKey];
+        if (defaultValue) {
+            [self storeCurrentValue:defaultValue.boolValue];
+            [self updateActiveState];
+            [self updateExpiry];
+            [self updateCPUBudgetMonitor];
+        }
+        _store = store;
     }
 }
 
 - (void) saveState
 {
-    if (_defaultsKey && _userDefaults) {
-        [_userDefaults setBool:self.currentValue forKey:_defaultsKey];
-        [_userDefaults synchronize]; // make it persistent even if the app is killed soon after
+    if (_defaultsKey && _store) {
+        // A temporary value must not survive a relaunch.
+        if (self.isExpiring)
+            [_store removeObjectForKey:_defaultsKey];
+        else
+            [_store setObject:@(self.currentValue) forKey:_defaultsKey];
+        [_store synchronize]; // make it persistent even if the app is killed soon after
     }
 }
 
@@ -127,6 +419,140 @@ NS_ASSUME_NONNULL_BEGIN
     self.currentValue = [kvValue boolValue];
 }
 
+#pragma mark - CPU Budget
+
+- (void) setCPUTimeCounter:(PWDebugCounter*)counter policy:(nullable PWDebugCPUBudgetPolicy*)policy
+{
+    NSParameterAssert (counter);
+
+    _cpuTimeCounter = counter;
+    self.cpuBudgetPolicy = policy;
+    [self updateCPUBudgetMonitor];
+}
+
+- (nullable PWDebugCPUBudgetPolicy*) effectiveCPUBudgetPolicy
+{
+    PWDebugCPUBudgetPolicy* policy = self.cpuBudgetPolicy;
+    return policy ? policy : self.group.effectiveCPUBudgetPolicy;
+}
+
+- (double) cpuLoad
+{
+    PWDebugLockLock (&_cpuBudgetLock);
+    double load = _cpuLoad;
+    PWDebugLockUnlock (&_cpuBudgetLock);
+    return load;
+}
+
+// Starts sampling while the switch is on, stops it while it is off.
+- (void) updateCPUBudgetMonitor
+{
+    if (!_cpuTimeCounter)
+        return;
+
+    BOOL monitoring = self.currentValue;
+
+    PWDebugLockLock (&_cpuBudgetLock);
+    PWDebugTimerWheelEntry* oldEntry = _cpuSampleEntry;
+    _cpuSampleEntry = nil;
+    _sampleHead  = 0;
+    _sampleCount = 0;
+    _cpuLoad     = 0.0;
+    if (monitoring) {
+        [self recordCPUSample];
+        [self scheduleCPUSample];
+    }
+    PWDebugLockUnlock (&_cpuBudgetLock);
+
+    if (oldEntry)
+        [PWDebugTimerWheel.sharedWheel cancelEntry:oldEntry];
+}
+
+// Must be called with _cpuBudgetLock held.
+- (void) scheduleCPUSample
+{
+    PWDebugCPUBudgetPolicy* policy = self.effectiveCPUBudgetPolicy;
+    if (!policy)
+        return;
+
+    __weak PWDebugSwitchOption* weakSelf = self;
+    __block __weak PWDebugTimerWheelEntry* weakEntry;
+    PWDebugTimerWheelEntry* entry = [PWDebugTimerWheel.sharedWheel scheduleAfter:policy.window / PW_CPU_BUDGET_SLICES_PER_WINDOW
+                                                                         handler:^{
+        [weakSelf sampleCPUTimeForEntry:weakEntry policy:policy];
+    }];
+    weakEntry = entry;
+    _cpuSampleEntry = entry;
+}
+
+// Must be called with _cpuBudgetLock held. Keeps the last PW_CPU_BUDGET_SLICES_PER_WINDOW + 1 samples.
+- (void) recordCPUSample
+{
+    const NSUInteger capacity = PW_CPU_BUDGET_SLICES_PER_WINDOW + 1;
+    NSUInteger index = (_sampleHead + _sampleCount) % capacity;
+    if (_sampleCount < capacity)
+        ++_sampleCount;
+    else
+        _sampleHead = (_sampleHead + 1) % capacity;
+    _sampleTimes[index]  = PWDebugMonotonicNanoseconds ();
+    _sampleValues[index] = PWDebugCounterValue (_cpuTimeCounter);
+}
+
+- (void) sampleCPUTimeForEntry:(nullable PWDebugTimerWheelEntry*)entry policy:(PWDebugCPUBudgetPolicy*)policy
+{
+    PWDebugLockLock (&_cpuBudgetLock);
+    if (!entry || entry != _cpuSampleEntry) {
+        PWDebugLockUnlock (&_cpuBudgetLock);
+        return;     // the switch changed meanwhile
+    }
+
+    [self recordCPUSample];
+    NSUInteger newest = (_sampleHead + _sampleCount - 1) % (PW_CPU_BUDGET_SLICES_PER_WINDOW + 1);
+    uint64_t elapsed = _sampleTimes[newest] - _sampleTimes[_sampleHead];
+    if (elapsed > 0)
+        _cpuLoad = (_sampleValues[newest] - _sampleValues[_sampleHead]) / (double)elapsed;
+
+    // Judge only full windows, a single slow scope at the start of a window would trip the budget too early.
+    double load = _cpuLoad;
+    BOOL exceeded = (_sampleCount == PW_CPU_BUDGET_SLICES_PER_WINDOW + 1) && load > policy.fraction;
+    NSUInteger generation = _valueGeneration;
+    if (exceeded)
+        _cpuSampleEntry = nil;
+    else
+        [self scheduleCPUSample];
+    PWDebugLockUnlock (&_cpuBudgetLock);
+
+    if (exceeded)
+        [self turnOffForCPULoad:load policy:policy generation:generation];
+}
+
+// Turns the switch off unless it was changed since the budget was judged, in which case the new value wins. Runs on
+// the handler queue of the shared timer wheel, the notifications follow on the main queue.
+- (void) turnOffForCPULoad:(double)load policy:(PWDebugCPUBudgetPolicy*)policy generation:(NSUInteger)generation
+{
+    PWDebugLockLock (&_cpuBudgetLock);
+    BOOL tripped = (_valueGeneration == generation) && atomic_load_explicit (_target, memory_order_acquire);
+    if (tripped) {
+        atomic_store_explicit (_target, NO, memory_order_release);
+        ++_valueGeneration;
+    }
+    PWDebugLockUnlock (&_cpuBudgetLock);
+    if (!tripped)
+        return;
+
+    NSLog (@"Debug option \"%@\" spent %.1f %% of the time in guarded scopes, exceeding its budget of %@. "
+           @"Turning it off.", self.title, load * 100.0, policy);
+    [self updateActiveState];
+    [self updateExpiry];
+    [self updateCPUBudgetMonitor];
+    [self postChangeNotificationsOnMainQueue];
+    dispatch_async (dispatch_get_main_queue (), ^{
+        [NSNotificationCenter.defaultCenter postNotificationName:PWDebugOptionCPUBudgetExceededNotification
+                                                          object:self
+                                                        userInfo:@{ PWDebugOptionCPULoadKey: @(load) }];
+    });
+}
+
 @end
 
 #pragma mark -
@@ -146,7 +572,8 @@ NS_ASSUME_NONNULL_BEGIN
     self = [super initWithTitle:title toolTip:toolTip];
     _asSubMenu = flag;
     _target    = target;
-    *_target   = value;
+    _defaultValue = value;
+    atomic_store_explicit (_target, value, memory_order_release);
 
     // Collect titles and values.
     NSMutableArray<NSString*>* theTitles = [[NSMutableArray alloc] init];
@@ -178,33 +605,75 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (NSInteger) currentValue
 {
-    return *_target;
+    return atomic_load_explicit (_target, memory_order_acquire);
 }
 
 - (void) setCurrentValue:(NSInteger)value
 {
     [self.groupClass willChangeValueForKey:self.propertyName];
-    *_target = value;
+    [self applyCurrentValue:value];
     [self.groupClass didChangeValueForKey:self.propertyName];
+    [self postDidChangeNotification];
 }
 
-- (void) loadStateFromUserDefaults:(NSUserDefaults*)userDefaults
+- (void) applyCurrentValue:(NSInteger)value
 {
-    NSParameterAssert (userDefaults);
+    atomic_store_explicit (_target, value, memory_order_release);
+    [self updateActiveState];
+    [self updateExpiry];
+}
+
+- (BOOL) hasDefaultValue
+{
+    return self.currentValue == _defaultValue;
+}
+
+- (void) revertToDefaultValue
+{
+    self.currentValue = _defaultValue;
+}
+
+- (void) applyDefaultValue
+{
+    [self applyCurrentValue:_defaultValue];
+}
+
+- (void) setActiveTarget:(nullable _Atomic (NSInteger)*)activeTarget
+{
+    _activeTarget = activeTarget;
+    [self updateActiveState];
+}
+
+- (void) updateActiveStateForGroupEnabled:(BOOL)groupEnabled
+{
+    if (_activeTarget)
+        atomic_store_explicit (_activeTarget, groupEnabled ? self.currentValue : _defaultValue, memory_order_release);
+}
+
+- (void) loadStateFromStore:(id<PWDebugOptionStore>)store
+{
+    NSParameterAssert (store);
 
     if (_defaultsKey) {
-        NSNumber* defaultValue = [userDefaults objectForKey:_defaultsKey];
-        if (defaultValue)
-            *_target = defaultValue.integerValue;
-        _userDefaults = userDefaults;
+        NSNumber* defaultValue = [store objectForKey:_defaultsKey];
+        if (defaultValue) {
+            atomic_store_explicit (_target, defaultValue.integerValue, memory_order_release);
+            [self updateActiveState];
+            [self updateExpiry];
+        }
+        _store = store;
     }
 }
 
 - (void) saveState
 {
-    if (_defaultsKey && _userDefaults) {
-        [_userDefaults setInteger:self.currentValue forKey:_defaultsKey];
-        [_userDefaults synchronize]; // make it persistent even if the app is killed soon after
+    if (_defaultsKey && _store) {
+        // A temporary value must not survive a relaunch.
+        if (self.isExpiring)
+            [_store removeObjectForKey:_defaultsKey];
+        else
+            [_store setObject:@(self.currentValue) forKey:_defaultsKey];
+        [_store synchronize]; // make it persistent even if the app is killed soon after
     }
 }
 
@@ -223,6 +692,26 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark -
 
+// Serializes the accesses to all text targets. Text changes are rare, so one lock for all of them does not contend.
+static PWDebugLock sTextTargetLock = PW_DEBUG_LOCK_INIT;
+
+NSString*_Nullable PWDebugTextOptionLoad (__strong NSString*_Nullable *_Nonnull target)
+{
+    PWDebugLockLock (&sTextTargetLock);
+    NSString* value = *target;  // retained while the lock keeps writers out
+    PWDebugLockUnlock (&sTextTargetLock);
+    return value;
+}
+
+static void PWDebugTextOptionStore (__strong NSString*_Nullable *_Nonnull target, NSString*_Nullable value)
+{
+    PWDebugLockLock (&sTextTargetLock);
+    // Released at the end of the function, outside of the lock.
+    __attribute__((objc_precise_lifetime, unused)) NSString* oldValue = *target;
+    *target = value;
+    PWDebugLockUnlock (&sTextTargetLock);
+}
+
 @implementation PWDebugTextOption
 
 - (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip
@@ -233,7 +722,7 @@ NS_ASSUME_NONNULL_BEGIN
     
     self = [super initWithTitle:title toolTip:toolTip];
     _target  = target;
-    *_target = nil;
+    PWDebugTextOptionStore (_target, nil);
     if (keySuffix) {
         _defaultsKey = [self.class defaultsKeyForDebugOptionName:keySuffix];
 //        id defaultValue = [NSUserDefaults.standardUserDefaults objectForKey:_defaultsKey];
@@ -245,33 +734,34 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable NSString*) currentValue
 {
-    return *_target;
+    return PWDebugTextOptionLoad (_target);
 }
 
 - (void) setCurrentValue:(nullable NSString*)value
 {
     [self.groupClass willChangeValueForKey:self.propertyName];
-    *_target = value;
+    PWDebugTextOptionStore (_target, [value copy]);
     [self.groupClass didChangeValueForKey:self.propertyName];
+    [self postDidChangeNotification];
 }
 
-- (void) loadStateFromUserDefaults:(NSUserDefaults*)userDefaults
+- (void) loadStateFromStore:(id<PWDebugOptionStore>)store
 {
-    NSParameterAssert (userDefaults);
+    NSParameterAssert (store);
 
     if (_defaultsKey) {
-        id defaultValue = [userDefaults objectForKey:_defaultsKey];
+        id defaultValue = [store objectForKey:_defaultsKey];
         if ([defaultValue isKindOfClass:NSString.class])
-            *_target = defaultValue;
-        _userDefaults = userDefaults;
+            PWDebugTextOptionStore (_target, defaultValue);
+        _store = store;
     }
 }
 
 - (void) saveState
 {
-    if (_defaultsKey && _userDefaults) {
-        [_userDefaults setObject:self.currentValue forKey:_defaultsKey];
-        [_userDefaults synchronize]; // make it persistent even if the app is killed soon after
+    if (_defaultsKey && _store) {
+        [_store setObject:self.currentValue forKey:_defaultsKey];
+        [_store synchronize]; // make it persistent even if the app is killed soon after
     }
 }
 
@@ -311,6 +801,155 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark -
 
+_Thread_local unsigned PWDebugCounterThreadShard;
+
+unsigned PWDebugCounterAssignThreadShard (void)
+{
+    static _Atomic (unsigned) sNextShard;
+    unsigned shard = atomic_fetch_add_explicit (&sNextShard, 1, memory_order_relaxed) % PW_DEBUG_COUNTER_SHARD_COUNT;
+    PWDebugCounterThreadShard = shard + 1;
+    return shard + 1;
+}
+
+int64_t PWDebugCounterValue (PWDebugCounter* counter)
+{
+    NSCParameterAssert (counter);
+
+    int64_t sum = 0;
+    for (unsigned i = 0; i < PW_DEBUG_COUNTER_SHARD_COUNT; ++i)
+        sum += atomic_load_explicit (&counter->shards[i].value, memory_order_relaxed);
+    return sum;
+}
+
+void PWDebugCounterReset (PWDebugCounter* counter)
+{
+    NSCParameterAssert (counter);
+
+    // The shards are zeroed one by one, so the reset is not atomic with respect to concurrent increments: one racing
+    // with the reset is kept or discarded depending on whether its shard was zeroed already.
+    for (unsigned i = 0; i < PW_DEBUG_COUNTER_SHARD_COUNT; ++i)
+        atomic_store_explicit (&counter->shards[i].value, 0, memory_order_relaxed);
+}
+
+@implementation PWDebugCounterOption
+
+- (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip
+                       counter:(PWDebugCounter*)counter
+{
+    NSParameterAssert (counter);
+
+    self = [super initWithTitle:title toolTip:toolTip];
+    _counter = counter;
+    return self;
+}
+
+- (int64_t) value
+{
+    return PWDebugCounterValue (_counter);
+}
+
+- (void) reset
+{
+    [self.groupClass willChangeValueForKey:self.propertyName];
+    PWDebugCounterReset (_counter);
+    [self.groupClass didChangeValueForKey:self.propertyName];
+    [self postDidChangeNotification];
+}
+
+- (nullable id) kvValue
+{
+    return @(self.value);
+}
+
+- (void) setKvValue:(nullable id)kvValue
+{
+    NSAssert (NO, @"counters can only be reset");
+}
+
+@end
+
+#pragma mark -
+
+NSNotificationName const PWDebugAsyncActionOptionRunningStateDidChangeNotification = @"PWDebugAsyncActionOptionRunningStateDidChange";
+
+@interface PWDebugAsyncActionBlockOption ()
+
+@property (atomic, readwrite, nullable)     NSProgress*             progress;
+@property (atomic, readwrite)               NSTimeInterval          lastExecutionDuration;
+
+@end
+
+@implementation PWDebugAsyncActionBlockOption
+{
+    _Atomic (BOOL)  _running;
+}
+
+- (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip
+                         queue:(nullable dispatch_queue_t)queue
+                   actionBlock:(PWDebugAsyncActionBlock)block
+{
+    NSParameterAssert (block);
+
+    self = [super initWithTitle:title toolTip:toolTip];
+    _block = [block copy];
+#ifdef __APPLE__
+    _queue = queue ? queue : dispatch_get_global_queue (QOS_CLASS_UTILITY, 0);
+#else
+    _queue = queue ? queue : dispatch_get_global_queue (DISPATCH_QUEUE_PRIORITY_LOW, 0);
+#endif
+    return self;
+}
+
+- (BOOL) isRunning
+{
+    return _running;
+}
+
+- (void) execute:(nullable id)sender
+{
+    // Only the caller which flips _running from NO to YES gets to start a run.
+    BOOL expected = NO;
+    if (!atomic_compare_exchange_strong (&_running, &expected, YES))
+        return;
+
+    NSProgress* progress = [NSProgress discreteProgressWithTotalUnitCount:-1];
+    self.progress = progress;
+    [self postRunningStateDidChange];
+
+    PWDebugAsyncActionBlock block = _block;
+    dispatch_async (_queue, ^{
+        uint64_t startTime = PWDebugMonotonicNanoseconds ();
+        block (progress);
+        NSTimeInterval duration = (PWDebugMonotonicNanoseconds () - startTime) / (double)NSEC_PER_SEC;
+
+        self.lastExecutionDuration = duration;
+        self.progress = nil;
+        self->_running = NO;
+        [self postRunningStateDidChange];
+    });
+}
+
+- (void) cancel
+{
+    [self.progress cancel];
+}
+
+- (void) postRunningStateDidChange
+{
+    void (^post) (void) = ^{
+        [NSNotificationCenter.defaultCenter
+         postNotificationName:PWDebugAsyncActionOptionRunningStateDidChangeNotification object:self];
+    };
+    if (NSThread.isMainThread)
+        post ();
+    else
+        dispatch_async (dispatch_get_main_queue (), post);
+}
+
+@end
+
+#pragma mark -
+
 @implementation PWDebugActionWithNamedTargetOption
 
 - (instancetype) initWithTitle:(NSString*)title toolTip:(nullable NSString*)toolTip
@@ -0,0 +1,63 @@
+//
+//  PWDebugTimerWheel.h
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <Foundation/Foundation.h>
+#import <dispatch/dispatch.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A timer scheduled in a PWDebugTimerWheel.
+@interface PWDebugTimerWheelEntry : NSObject
+
+- (instancetype) init NS_UNAVAILABLE;
+
+/// Seconds until the entry is due, 0 if it is overdue, fired or cancelled.
+@property (nonatomic, readonly)     NSTimeInterval  remainingTime;
+
+@property (atomic, readonly)        BOOL            isCancelled;
+
+@end
+
+#pragma mark -
+
+/// Hashed timer wheel. Entries are sorted into 'slotCount' slots by their deadline, and a single timer advances the
+/// wheel by one slot per tick, firing the due entries of that slot. This keeps the cost of many timers at one timer
+/// source. The timer runs only while entries are scheduled. Deadlines are rounded up to whole ticks.
+/// Thread safe.
+@interface PWDebugTimerWheel : NSObject
+
+/// Handlers are dispatched asynchronously to 'handlerQueue'.
+- (instancetype) initWithTickInterval:(NSTimeInterval)tickInterval
+                            slotCount:(NSUInteger)slotCount
+                         handlerQueue:(dispatch_queue_t)handlerQueue NS_DESIGNATED_INITIALIZER;
+- (instancetype) init NS_UNAVAILABLE;
+
+/// The wheel used by debug options: quarter second ticks, handlers on a private serial queue. It does not depend on
+/// the main run loop, therefore expiry and CPU budgets work in command line tools and daemons as well.
+@property (class, readonly, strong) PWDebugTimerWheel*  sharedWheel;
+
+@property (nonatomic, readonly)     dispatch_queue_t    handlerQueue;
+
+@property (nonatomic, readonly)     NSTimeInterval      tickInterval;
+@property (nonatomic, readonly)     NSUInteger          slotCount;
+
+/// Number of scheduled entries which did neither fire nor were cancelled yet.
+@property (nonatomic, readonly)     NSUInteger          count;
+
+- (PWDebugTimerWheelEntry*) scheduleAfter:(NSTimeInterval)delay handler:(dispatch_block_t)handler;
+
+/// The handler of a cancelled entry is not called, even if it was already dispatched to the handler queue, provided
+/// the entry is cancelled on the handler queue.
+- (void) cancelEntry:(PWDebugTimerWheelEntry*)entry;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,218 @@
+//
+//  PWDebugTimerWheel.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import "PWDebugTimerWheel.h"
+#import "PWDebugOptions.h"
+#import "PWDebugLock.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface PWDebugTimerWheelEntry ()
+
+- (instancetype) initWithDeadline:(uint64_t)deadline tick:(uint64_t)tick handler:(dispatch_block_t)handler NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, readonly)             uint64_t            deadline;   // monotonic nanoseconds
+@property (nonatomic, readonly)             uint64_t            tick;
+@property (nonatomic, readonly, copy)       dispatch_block_t    handler;
+@property (atomic, readwrite)               BOOL                isCancelled;
+
+@end
+
+#pragma mark -
+
+@implementation PWDebugTimerWheel
+{
+    uint64_t                                        _tickNanoseconds;
+    uint64_t                                        _startTime;
+    dispatch_queue_t                                _handlerQueue;
+    dispatch_source_t                               _timer;
+
+    PWDebugLock                                     _lock;
+    NSMutableArray<NSMutableArray<PWDebugTimerWheelEntry*>*>*   _slots;     // protected by _lock
+    uint64_t                                        _currentTick;           // protected by _lock
+    NSUInteger                                      _count;                 // protected by _lock
+    BOOL                                            _timerRunning;          // protected by _lock
+}
+
+- (instancetype) initWithTickInterval:(NSTimeInterval)tickInterval
+                            slotCount:(NSUInteger)slotCount
+                         handlerQueue:(dispatch_queue_t)handlerQueue
+{
+    NSParameterAssert (tickInterval > 0.0);
+    NSParameterAssert (slotCount > 0);
+    NSParameterAssert (handlerQueue);
+
+    self = [super init];
+    _tickInterval    = tickInterval;
+    _slotCount       = slotCount;
+    _tickNanoseconds = MAX ((uint64_t)(tickInterval * NSEC_PER_SEC), 1);
+    _startTime       = PWDebugMonotonicNanoseconds ();
+    _handlerQueue    = handlerQueue;
+    PWDebugLockInit (&_lock);
+
+    _slots = [[NSMutableArray alloc] initWithCapacity:slotCount];
+    for (NSUInteger i = 0; i < slotCount; ++i)
+        [_slots addObject:[[NSMutableArray alloc] init]];
+
+    // The timer starts suspended and is resumed while entries are scheduled.
+    _timer = dispatch_source_create (DISPATCH_SOURCE_TYPE_TIMER, 0, 0,
+                                     dispatch_queue_create ("PWDebugTimerWheel", DISPATCH_QUEUE_SERIAL));
+    __weak PWDebugTimerWheel* weakSelf = self;
+    dispatch_source_set_event_handler (_timer, ^{
+        [weakSelf advance];
+    });
+    return self;
+}
+
+- (void) dealloc
+{
+    // A suspended source must be resumed before it is released.
+    dispatch_source_cancel (_timer);
+    if (!_timerRunning)
+        dispatch_resume (_timer);
+    PWDebugLockDestroy (&_lock);
+}
+
++ (PWDebugTimerWheel*) sharedWheel
+{
+    static PWDebugTimerWheel* sSharedWheel;
+    static dispatch_once_t sSharedWheelPredicate = 0;
+    dispatch_once (&sSharedWheelPredicate, ^{
+        sSharedWheel = [[self alloc] initWithTickInterval:0.25 slotCount:256
+                                             handlerQueue:dispatch_queue_create ("PWDebugTimerWheel.handlers",
+                                                                                 DISPATCH_QUEUE_SERIAL)];
+    });
+    return sSharedWheel;
+}
+
+- (NSUInteger) count
+{
+    PWDebugLockLock (&_lock);
+    NSUInteger count = _count;
+    PWDebugLockUnlock (&_lock);
+    return count;
+}
+
+- (uint64_t) tickAtTime:(uint64_t)time
+{
+    return (time - _startTime) / _tickNanoseconds;
+}
+
+- (PWDebugTimerWheelEntry*) scheduleAfter:(NSTimeInterval)delay handler:(dispatch_block_t)handler
+{
+    NSParameterAssert (handler);
+
+    uint64_t now = PWDebugMonotonicNanoseconds ();
+    uint64_t deadline = now + (uint64_t)(MAX (delay, 0.0) * NSEC_PER_SEC);
+
+    PWDebugLockLock (&_lock);
+    if (!_timerRunning)
+        _currentTick = [self tickAtTime:now];   // the wheel did not turn while idle
+
+    // Round up, and never schedule into the slot which is being processed.
+    uint64_t tick = (deadline - _startTime + _tickNanoseconds - 1) / _tickNanoseconds;
+    tick = MAX (tick, _currentTick + 1);
+
+    PWDebugTimerWheelEntry* entry = [[PWDebugTimerWheelEntry alloc] initWithDeadline:deadline tick:tick handler:handler];
+    [_slots[tick % _slotCount] addObject:entry];
+    ++_count;
+
+    if (!_timerRunning) {
+        _timerRunning = YES;
+        dispatch_source_set_timer (_timer, dispatch_time (DISPATCH_TIME_NOW, (int64_t)_tickNanoseconds),
+                                   _tickNanoseconds, _tickNanoseconds / 10);
+        dispatch_resume (_timer);
+    }
+    PWDebugLockUnlock (&_lock);
+    return entry;
+}
+
+- (void) cancelEntry:(PWDebugTimerWheelEntry*)entry
+{
+    NSParameterAssert (entry);
+
+    entry.isCancelled = YES;
+
+    PWDebugLockLock (&_lock);
+    NSMutableArray<PWDebugTimerWheelEntry*>* slot = _slots[entry.tick % _slotCount];
+    NSUInteger index = [slot indexOfObjectIdenticalTo:entry];
+    if (index != NSNotFound) {
+        [slot removeObjectAtIndex:index];
+        --_count;
+    }
+    PWDebugLockUnlock (&_lock);
+    // The timer stops at the next tick if the wheel became empty.
+}
+
+// Called by the timer once per tick.
+- (void) advance
+{
+    NSMutableArray<PWDebugTimerWheelEntry*>* dueEntries = [[NSMutableArray alloc] init];
+
+    PWDebugLockLock (&_lock);
+    // Ticks may have been skipped if the timer was late. Visiting more than one revolution is pointless.
+    uint64_t nowTick = [self tickAtTime:PWDebugMonotonicNanoseconds ()];
+    uint64_t lastTick = MIN (nowTick, _currentTick + _slotCount);
+    for (uint64_t iTick = _currentTick + 1; iTick <= lastTick; ++iTick) {
+        NSMutableArray<PWDebugTimerWheelEntry*>* iSlot = _slots[iTick % _slotCount];
+        // Entries further than one revolution ahead share the slot and stay.
+        NSIndexSet* dueIndexes = [iSlot indexesOfObjectsPassingTest:^BOOL (PWDebugTimerWheelEntry* entry, NSUInteger idx, BOOL* stop) {
+            return entry.tick <= nowTick;
+        }];
+        if (dueIndexes.count > 0) {
+            [dueEntries addObjectsFromArray:[iSlot objectsAtIndexes:dueIndexes]];
+            [iSlot removeObjectsAtIndexes:dueIndexes];
+            _count -= dueIndexes.count;
+        }
+    }
+    _currentTick = MAX (_currentTick, nowTick);
+
+    if (_count == 0 && _timerRunning) {
+        _timerRunning = NO;
+        dispatch_suspend (_timer);
+    }
+    PWDebugLockUnlock (&_lock);
+
+    for (PWDebugTimerWheelEntry* iEntry in dueEntries)
+        dispatch_async (_handlerQueue, ^{
+            if (!iEntry.isCancelled)
+                iEntry.handler ();
+        });
+}
+
+@end
+
+#pragma mark -
+
+@implementation PWDebugTimerWheelEntry
+
+- (instancetype) initWithDeadline:(uint64_t)deadline tick:(uint64_t)tick handler:(dispatch_block_t)handler
+{
+    NSParameterAssert (handler);
+
+    self = [super init];
+    _deadline = deadline;
+    _tick     = tick;
+    _handler  = [handler copy];
+    return self;
+}
+
+- (NSTimeInterval) remainingTime
+{
+    if (self.isCancelled)
+        return 0.0;
+    uint64_t now = PWDebugMonotonicNanoseconds ();
+    return (_deadline > now) ? (_deadline - now) / (double)NSEC_PER_SEC : 0.0;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,411 @@
+//
+//  PWDebugOptionsStress.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+// Stress and scalability harness: reader threads on switch, enumeration and text targets, writer threads changing the
+// options, and a thread which registers and removes observers and sorts the options, all at the same time. Prints
+// throughput and latency percentiles for a growing number of readers. Build and run it with the Makefile in this
+// directory, "make check" runs it under ThreadSanitizer.
+//
+//  usage: PWDebugOptionsStress [step duration in seconds] [maximum number of readers]
+//
+// Exits with status 1 if a reader saw a value which was never written or a workload made no progress.
+
+#import <Foundation/Foundation.h>
+#import <stdatomic.h>
+#import <stdlib.h>
+#import "PWDebugOptionMacros.h"
+#import "PWDebugOptionFileStore.h"
+
+DEBUG_OPTION_DECLARE_GROUP (StressGroup)
+DEBUG_OPTION_DEFINE_GROUP (StressGroup, PWRootDebugOptionGroup,
+                           @"Stress Group", @"A group for the stress harness")
+
+DEBUG_OPTION_SWITCH (PWDebugOptionStressSwitch, StressGroup,
+                     @"Stress Switch", @"A switch changed by several threads",
+                     DEBUG_OPTION_DEFAULT_OFF, DEBUG_OPTION_NON_PERSISTENT)
+
+DEBUG_OPTION_ENUM (PWDebugOptionStressEnum, StressGroup,
+                   @"Stress Enum", @"An enumeration changed by several threads", DEBUG_OPTION_ENUM_INLINE,
+                   NSInteger, 1, DEBUG_OPTION_NON_PERSISTENT,
+                   @"One", 1,
+                   @"Two", 2,
+                   @"Three", 3,
+                   nil)
+
+DEBUG_OPTION_TEXT (PWDebugOptionStressText, StressGroup,
+                   @"Stress Text", @"A text changed by several threads",
+                   DEBUG_OPTION_NON_PERSISTENT)
+
+static const NSUInteger     PWStressWriterCount     = 2;
+static const NSUInteger     PWStressSampleInterval  = 61;       // every 61st read is timed, rotating through the kinds
+static const NSUInteger     PWStressMaxSamples      = 1 << 16;  // per thread and kind
+static const NSUInteger     PWStressReadsPerPool    = 1024;
+
+typedef NS_ENUM (NSUInteger, PWStressReadKind) {
+    PWStressReadSwitch,
+    PWStressReadEnum,
+    PWStressReadText,
+    PWStressReadKindCount
+};
+
+/// Latency samples of one thread, in nanoseconds.
+typedef struct {
+    uint64_t*   values;
+    NSUInteger  count;
+} PWStressSamples;
+
+/// State of one thread, written by that thread only and read after it finished.
+typedef struct {
+    PWStressSamples     samples[PWStressReadKindCount];     // writers and the churn thread use the first one only
+    uint64_t            operations;
+} PWStressThreadState;
+
+static void PWStressSamplesAdd (PWStressSamples* samples, uint64_t value)
+{
+    if (!samples->values)
+        samples->values = malloc (PWStressMaxSamples * sizeof (uint64_t));
+    if (samples->count < PWStressMaxSamples)
+        samples->values[samples->count++] = value;
+}
+
+static int PWStressCompareSamples (const void* lhs, const void* rhs)
+{
+    uint64_t a = *(const uint64_t*)lhs;
+    uint64_t b = *(const uint64_t*)rhs;
+    return (a > b) - (a < b);
+}
+
+/// Merges the samples of 'kind' of all threads and returns the requested percentiles.
+static void PWStressPercentiles (PWStressThreadState* states, NSUInteger stateCount, PWStressReadKind kind,
+                                 const double* percentiles, uint64_t* results, NSUInteger percentileCount)
+{
+    NSUInteger total = 0;
+    for (NSUInteger i = 0; i < stateCount; ++i)
+        total += states[i].samples[kind].count;
+    uint64_t* merged = malloc (MAX (total, 1) * sizeof (uint64_t));
+    NSUInteger offset = 0;
+    for (NSUInteger i = 0; i < stateCount; ++i) {
+        PWStressSamples* iSamples = &states[i].samples[kind];
+        if (iSamples->count > 0)
+            memcpy (merged + offset, iSamples->values, iSamples->count * sizeof (uint64_t));
+        offset += iSamples->count;
+    }
+    qsort (merged, total, sizeof (uint64_t), PWStressCompareSamples);
+    for (NSUInteger i = 0; i < percentileCount; ++i)
+        results[i] = (total > 0) ? merged[MIN ((NSUInteger)(percentiles[i] * total), total - 1)] : 0;
+    free (merged);
+}
+
+static void PWStressFreeStates (PWStressThreadState* states, NSUInteger stateCount)
+{
+    for (NSUInteger i = 0; i < stateCount; ++i)
+        for (NSUInteger iKind = 0; iKind < PWStressReadKindCount; ++iKind)
+            free (states[i].samples[iKind].values);
+    free (states);
+}
+
+static _Atomic (BOOL)       sStopStress;
+static _Atomic (NSUInteger) sInvalidReads;
+static _Atomic (uint64_t)   sObservedChanges;
+
+#pragma mark -
+
+/// Counts notifications; instances come and go while writers notify.
+@interface PWStressObserver : NSObject
+@end
+
+@implementation PWStressObserver
+
+- (void) observeValueForKeyPath:(nullable NSString*)keyPath
+                       ofObject:(nullable id)object
+                         change:(nullable NSDictionary<NSKeyValueChangeKey, id>*)change
+                        context:(nullable void*)context
+{
+    atomic_fetch_add_explicit (&sObservedChanges, 1, memory_order_relaxed);
+}
+
+@end
+
+#pragma mark -
+
+/// Starts threads and waits for all of them. Uses NSCondition, which ThreadSanitizer sees as synchronization, so the
+/// thread states can be read after -wait without further ado.
+@interface PWStressThreadGroup : NSObject
+
+- (void) detachThreadWithBlock:(void (^) (void))block;
+- (void) wait;
+
+@end
+
+@implementation PWStressThreadGroup
+{
+    NSCondition*    _condition;
+    NSUInteger      _running;   // protected by _condition
+}
+
+- (instancetype) init
+{
+    self = [super init];
+    _condition = [[NSCondition alloc] init];
+    return self;
+}
+
+- (void) detachThreadWithBlock:(void (^) (void))block
+{
+    NSParameterAssert (block);
+
+    [_condition lock];
+    ++_running;
+    [_condition unlock];
+    [NSThread detachNewThreadSelector:@selector (runBlock:) toTarget:self withObject:[block copy]];
+}
+
+- (void) runBlock:(void (^) (void))block
+{
+    @autoreleasepool {
+        block ();
+    }
+    [_condition lock];
+    --_running;
+    [_condition broadcast];
+    [_condition unlock];
+}
+
+- (void) wait
+{
+    [_condition lock];
+    while (_running > 0)
+        [_condition wait];
+    [_condition unlock];
+}
+
+@end
+
+#pragma mark -
+
+static PWDebugOptionGroup* PWStressGroup (void)
+{
+    return [[PWRootDebugOptionGroup.sharedRootGroup optionWithTitle:@"Stress Group"] subGroup];
+}
+
+/// Time of two consecutive clock reads, which is included in every latency sample.
+static uint64_t PWStressClockOverhead (void)
+{
+    uint64_t minimum = UINT64_MAX;
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t start = PWDebugMonotonicNanoseconds ();
+        minimum = MIN (minimum, PWDebugMonotonicNanoseconds () - start);
+    }
+    return minimum;
+}
+
+/// Reads one target of 'kind' and checks the value.
+static NSUInteger PWStressRead (PWStressReadKind kind, NSArray<NSString*>* texts)
+{
+    switch (kind) {
+        case PWStressReadSwitch:
+            return DEBUG_OPTION_ACTIVE (PWDebugOptionStressSwitch);
+
+        case PWStressReadEnum: {
+            NSInteger value = DEBUG_OPTION_READ (PWDebugOptionStressEnum);
+            if (value < 1 || value > 3)
+                ++sInvalidReads;
+            return (NSUInteger)value;
+        }
+
+        case PWStressReadText: {
+            NSString* text = DEBUG_OPTION_READ_TEXT (PWDebugOptionStressText);
+            if (text && ![texts containsObject:text])
+                ++sInvalidReads;
+            return text.length;
+        }
+
+        case PWStressReadKindCount:
+            break;
+    }
+    return 0;
+}
+
+/// Runs all workloads with 'readerCount' readers for 'duration' seconds and prints one line of results.
+/// Returns NO if a workload made no progress.
+static BOOL PWStressRunStep (NSUInteger readerCount, NSTimeInterval duration)
+{
+    PWDebugOptionGroup* group = PWStressGroup ();
+    PWDebugSwitchOption* switchOption = [group optionWithTitle:@"Stress Switch"];
+    PWDebugEnumOption* enumOption = [group optionWithTitle:@"Stress Enum"];
+    PWDebugTextOption* textOption = [group optionWithTitle:@"Stress Text"];
+    NSArray<NSString*>* texts = @[@"alpha", @"beta", @"gamma"];
+
+    PWStressThreadGroup* threads = [[PWStressThreadGroup alloc] init];
+    PWStressThreadState* readerStates = calloc (readerCount, sizeof (PWStressThreadState));
+    PWStressThreadState* writerStates = calloc (PWStressWriterCount, sizeof (PWStressThreadState));
+    PWStressThreadState* churnState   = calloc (1, sizeof (PWStressThreadState));
+    sStopStress = NO;
+
+    for (NSUInteger i = 0; i < readerCount; ++i) {
+        PWStressThreadState* state = &readerStates[i];
+        [threads detachThreadWithBlock:^{
+            NSUInteger sum = 0;
+            NSUInteger iRead = 0;
+            while (!sStopStress) {
+                @autoreleasepool {
+                    for (NSUInteger iBatchRead = 0; iBatchRead < PWStressReadsPerPool; ++iBatchRead, ++iRead) {
+                        PWStressReadKind kind = iRead % PWStressReadKindCount;
+                        if (iRead % PWStressSampleInterval == 0) {
+                            uint64_t start = PWDebugMonotonicNanoseconds ();
+                            sum += PWStressRead (kind, texts);
+                            PWStressSamplesAdd (&state->samples[kind], PWDebugMonotonicNanoseconds () - start);
+                        } else
+                            sum += PWStressRead (kind, texts);
+                    }
+                }
+            }
+            state->operations = iRead;
+            (void) sum;
+        }];
+    }
+
+    for (NSUInteger i = 0; i < PWStressWriterCount; ++i) {
+        PWStressThreadState* state = &writerStates[i];
+        NSUInteger firstWrite = i;
+        [threads detachThreadWithBlock:^{
+            for (NSUInteger iWrite = firstWrite; !sStopStress; ++iWrite) {
+                @autoreleasepool {
+                    NSUInteger round = iWrite / 3;
+                    uint64_t start = PWDebugMonotonicNanoseconds ();
+                    switch (iWrite % 3) {
+                        case 0: switchOption.currentValue = !switchOption.currentValue; break;
+                        case 1: enumOption.currentValue = 1 + (NSInteger)(round % 3); break;
+                        case 2: textOption.currentValue = (round % 4 == 3) ? nil : texts[round % texts.count]; break;
+                    }
+                    PWStressSamplesAdd (&state->samples[0], PWDebugMonotonicNanoseconds () - start);
+                    ++state->operations;
+                }
+                usleep (100);   // writers are rare in real use, they must not starve the readers
+            }
+        }];
+    }
+
+    [threads detachThreadWithBlock:^{
+        BOOL ascending = NO;
+        while (!sStopStress) {
+            @autoreleasepool {
+                uint64_t start = PWDebugMonotonicNanoseconds ();
+                PWStressObserver* observer = [[PWStressObserver alloc] init];
+                [StressGroup addObserver:observer forKeyPath:@"PWDebugOptionStressSwitch" options:0 context:NULL];
+                [StressGroup addObserver:observer forKeyPath:@"PWDebugOptionStressEnum" options:0 context:NULL];
+                [group sortOptionsUsingComparator:^NSComparisonResult (PWDebugOption* lhs, PWDebugOption* rhs) {
+                    NSComparisonResult result = [lhs.title compare:rhs.title];
+                    return ascending ? result : -result;
+                }];
+                ascending = !ascending;
+                (void)[group optionWithTitle:@"Stress Text"];
+                [StressGroup removeObserver:observer forKeyPath:@"PWDebugOptionStressSwitch" context:NULL];
+                [StressGroup removeObserver:observer forKeyPath:@"PWDebugOptionStressEnum" context:NULL];
+                PWStressSamplesAdd (&churnState->samples[0], PWDebugMonotonicNanoseconds () - start);
+                ++churnState->operations;
+            }
+        }
+    }];
+
+    [NSThread sleepForTimeInterval:duration];
+    sStopStress = YES;
+    [threads wait];
+
+    uint64_t reads = 0;
+    for (NSUInteger i = 0; i < readerCount; ++i)
+        reads += readerStates[i].operations;
+    uint64_t writes = 0;
+    for (NSUInteger i = 0; i < PWStressWriterCount; ++i)
+        writes += writerStates[i].operations;
+
+    const double readPercentiles[] = { 0.5, 0.99, 0.999 };
+    uint64_t readResults[PWStressReadKindCount][3];
+    for (NSUInteger iKind = 0; iKind < PWStressReadKindCount; ++iKind)
+        PWStressPercentiles (readerStates, readerCount, iKind, readPercentiles, readResults[iKind], 3);
+
+    const double writePercentiles[] = { 0.5, 0.99, 0.999 };
+    uint64_t writeResults[3];
+    PWStressPercentiles (writerStates, PWStressWriterCount, 0, writePercentiles, writeResults, 3);
+
+    printf ("%7lu %12.0f %5llu/%5llu/%6llu %5llu/%5llu/%6llu %5llu/%5llu/%6llu %10.0f %7.1f/%7.1f/%8.1f %9.0f\n",
+            (unsigned long)readerCount, reads / duration,
+            readResults[PWStressReadSwitch][0], readResults[PWStressReadSwitch][1], readResults[PWStressReadSwitch][2],
+            readResults[PWStressReadEnum][0], readResults[PWStressReadEnum][1], readResults[PWStressReadEnum][2],
+            readResults[PWStressReadText][0], readResults[PWStressReadText][1], readResults[PWStressReadText][2],
+            writes / duration, writeResults[0] / 1000.0, writeResults[1] / 1000.0, writeResults[2] / 1000.0,
+            churnState->operations / duration);
+    fflush (stdout);
+
+    BOOL progressed = reads > 0 && writes > 0 && churnState->operations > 0;
+    PWStressFreeStates (readerStates, readerCount);
+    PWStressFreeStates (writerStates, PWStressWriterCount);
+    PWStressFreeStates (churnState, 1);
+    return progressed;
+}
+
+int main (int argc, const char* argv[])
+{
+    @autoreleasepool {
+        NSTimeInterval duration = (argc > 1) ? strtod (argv[1], NULL) : 0.5;
+        NSUInteger maxReaderCount = (argc > 2) ? strtoul (argv[2], NULL, 10)
+                                               : 2 * MAX (NSProcessInfo.processInfo.activeProcessorCount, 1);
+        if (duration <= 0.0 || maxReaderCount == 0) {
+            fprintf (stderr, "usage: %s [step duration in seconds] [maximum number of readers]\n", argv[0]);
+            return 2;
+        }
+
+        // Keep the harness away from the user defaults of the machine it runs on.
+        if (!NSProcessInfo.processInfo.environment[@"PW_DEBUG_OPTIONS_STORE"]) {
+            NSString* path = [NSTemporaryDirectory () stringByAppendingPathComponent:@"PWDebugOptionsStress.store"];
+            NSError* error;
+            PWDebugOptionFileStore* store = [PWDebugOptionFileStore storeWithPath:path error:&error];
+            if (!store) {
+                fprintf (stderr, "can’t open %s: %s\n", path.fileSystemRepresentation, error.description.UTF8String);
+                return 1;
+            }
+            PWRootDebugOptionGroup.defaultStore = store;
+        }
+        if (!PWStressGroup ()) {
+            fprintf (stderr, "stress group missing\n");
+            return 1;
+        }
+
+        printf ("Latencies in ns for reads (p50/p99/p99.9 of single timed reads, including %llu ns clock overhead),\n"
+                "in µs for writes. Rates per second.\n\n", PWStressClockOverhead ());
+        printf ("readers      reads/s   switch p50/p99/p99.9  enum p50/p99/p99.9  text p50/p99/p99.9"
+                "    writes/s   write p50/p99/p99.9    churn/s\n");
+
+        BOOL success = YES;
+        for (NSUInteger readerCount = 1; readerCount <= maxReaderCount; readerCount *= 2)
+            success = PWStressRunStep (readerCount, duration) && success;
+
+        NSUInteger invalidReads = sInvalidReads;
+        uint64_t observedChanges = sObservedChanges;
+        printf ("\n%lu invalid reads, %llu observed changes\n", (unsigned long)invalidReads, observedChanges);
+        if (invalidReads > 0 || observedChanges == 0)
+            success = NO;
+
+        // After the storm the options are consistent with their targets again.
+        PWDebugOptionGroup* group = PWStressGroup ();
+        PWDebugSwitchOption* switchOption = [group optionWithTitle:@"Stress Switch"];
+        PWDebugTextOption* textOption = [group optionWithTitle:@"Stress Text"];
+        switchOption.currentValue = YES;
+        textOption.currentValue = @"omega";
+        if (   !DEBUG_OPTION_ACTIVE (PWDebugOptionStressSwitch)
+            || ![DEBUG_OPTION_READ_TEXT (PWDebugOptionStressText) isEqualToString:@"omega"]
+            || group.options.count != 3) {
+            fprintf (stderr, "options are inconsistent after the run\n");
+            success = NO;
+        }
+        return success ? 0 : 1;
+    }
+}
@@ -0,0 +1,183 @@
+//
+//  PWDebugCPUBudgetTest.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <XCTest/XCTest.h>
+#import "PWDebugOptionMacros.h"
+
+/// Drives synthetic workloads through scopes guarded by switches with CPU budgets.
+@interface PWDebugCPUBudgetTest : XCTestCase
+@end
+
+DEBUG_OPTION_DECLARE_GROUP (TestCPUBudgetGroup)
+DEBUG_OPTION_DEFINE_GROUP (TestCPUBudgetGroup, PWRootDebugOptionGroup,
+                           @"CPU Budget Group", @"A group for testing CPU budgets")
+
+DEBUG_OPTION_GROUP_CPU_BUDGET (TestCPUBudgetGroup, 0.2, 1.0)
+
+DEBUG_OPTION_SWITCH (PWDebugOptionTestHeavyTracing, TestCPUBudgetGroup,
+                     @"Heavy Tracing", @"Spends most of the time tracing",
+                     DEBUG_OPTION_DEFAULT_OFF, DEBUG_OPTION_NON_PERSISTENT)
+
+DEBUG_OPTION_CPU_BUDGET (PWDebugOptionTestHeavyTracing, TestCPUBudgetGroup, 0.1, 1.0)
+
+DEBUG_OPTION_SWITCH (PWDebugOptionTestLightTracing, TestCPUBudgetGroup,
+                     @"Light Tracing", @"Traces a little now and then",
+                     DEBUG_OPTION_DEFAULT_OFF, DEBUG_OPTION_NON_PERSISTENT)
+
+DEBUG_OPTION_CPU_BUDGET (PWDebugOptionTestLightTracing, TestCPUBudgetGroup, 0, 0)
+
+DEBUG_OPTION_DECLARE_GROUP (TestCPUBudgetSubGroup)
+DEBUG_OPTION_DEFINE_GROUP (TestCPUBudgetSubGroup, TestCPUBudgetGroup,
+                           @"CPU Budget Sub Group", @"A sub group inheriting the CPU budget of its parent")
+
+DEBUG_OPTION_SWITCH (PWDebugOptionTestInheritedTracing, TestCPUBudgetSubGroup,
+                     @"Inherited Tracing", @"Traces from the start, judged by the budget of the parent group",
+                     DEBUG_OPTION_DEFAULT_ON, DEBUG_OPTION_NON_PERSISTENT)
+
+DEBUG_OPTION_CPU_BUDGET (PWDebugOptionTestInheritedTracing, TestCPUBudgetSubGroup, 0, 0)
+
+static _Atomic (BOOL) sStopWorkload;
+
+static void PWSpin (useconds_t microseconds)
+{
+    uint64_t end = PWDebugMonotonicNanoseconds () + microseconds * NSEC_PER_USEC;
+    while (PWDebugMonotonicNanoseconds () < end)
+        ;
+}
+
+@implementation PWDebugCPUBudgetTest
+
+- (PWDebugOptionGroup*) budgetGroup
+{
+    return [[PWRootDebugOptionGroup.sharedRootGroup optionWithTitle:@"CPU Budget Group"] subGroup];
+}
+
+/// Runs the workload on a background queue until the returned group is waited for.
+- (dispatch_group_t) startWorkload:(void (^) (void))workload
+{
+    sStopWorkload = NO;
+    dispatch_group_t group = dispatch_group_create ();
+    dispatch_group_async (group, dispatch_get_global_queue (QOS_CLASS_UTILITY, 0), ^{
+        while (!sStopWorkload)
+            workload ();
+    });
+    return group;
+}
+
+- (void) stopWorkload:(dispatch_group_t)group
+{
+    sStopWorkload = YES;
+    dispatch_group_wait (group, DISPATCH_TIME_FOREVER);
+}
+
+- (void) testPolicies
+{
+    PWDebugOptionGroup* group = self.budgetGroup;
+    XCTAssertEqual (group.cpuBudgetPolicy.fraction, 0.2);
+    XCTAssertNil (PWRootDebugOptionGroup.sharedRootGroup.cpuBudgetPolicy);
+
+    PWDebugSwitchOption* heavyOption = [group optionWithTitle:@"Heavy Tracing"];
+    XCTAssertEqual (heavyOption.cpuTimeCounter, &PWDebugOptionTestHeavyTracing_CPUTime);
+    XCTAssertEqual (heavyOption.effectiveCPUBudgetPolicy.fraction, 0.1);
+
+    PWDebugSwitchOption* lightOption = [group optionWithTitle:@"Light Tracing"];
+    XCTAssertNil (lightOption.cpuBudgetPolicy);
+    XCTAssertEqual (lightOption.effectiveCPUBudgetPolicy, group.cpuBudgetPolicy);
+}
+
+- (void) testInheritedPolicyMonitorsDefaultOnSwitch
+{
+    PWDebugOptionGroup* subGroup = [[self.budgetGroup optionWithTitle:@"CPU Budget Sub Group"] subGroup];
+    PWDebugSwitchOption* option = [subGroup optionWithTitle:@"Inherited Tracing"];
+    XCTAssertNil (subGroup.cpuBudgetPolicy);
+    XCTAssertEqual (option.effectiveCPUBudgetPolicy, self.budgetGroup.cpuBudgetPolicy);
+    XCTAssertTrue (DEBUG_OPTION_ACTIVE (PWDebugOptionTestInheritedTracing));   // never switched on by the test
+
+    // About 80 % of the time in the guarded scope, the budget inherited from the parent group is 20 %.
+    dispatch_group_t workload = [self startWorkload:^{
+        if (DEBUG_OPTION_ACTIVE (PWDebugOptionTestInheritedTracing)) {
+            DEBUG_OPTION_MEASURE_CPU (PWDebugOptionTestInheritedTracing);
+            PWSpin (4000);
+        }
+        usleep (1000);
+    }];
+
+    [self expectationForNotification:PWDebugOptionCPUBudgetExceededNotification object:option handler:nil];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    [self stopWorkload:workload];
+    XCTAssertFalse (option.currentValue);
+    XCTAssertFalse (DEBUG_OPTION_ACTIVE (PWDebugOptionTestInheritedTracing));
+}
+
+- (void) testWorkloadWithinBudgetKeepsRunning
+{
+    PWDebugSwitchOption* option = [self.budgetGroup optionWithTitle:@"Light Tracing"];
+    option.currentValue = YES;
+
+    // About 5 % of the time in the guarded scope, the budget is 20 %.
+    dispatch_group_t workload = [self startWorkload:^{
+        if (DEBUG_OPTION_ACTIVE (PWDebugOptionTestLightTracing)) {
+            DEBUG_OPTION_MEASURE_CPU (PWDebugOptionTestLightTracing);
+            PWSpin (500);
+        }
+        usleep (10000);
+    }];
+
+    XCTestExpectation* exceeded = [self expectationForNotification:PWDebugOptionCPUBudgetExceededNotification
+                                                             object:option handler:nil];
+    exceeded.inverted = YES;
+    [self waitForExpectations:@[exceeded] timeout:3.0];
+    [self stopWorkload:workload];
+
+    XCTAssertTrue (option.currentValue);
+    XCTAssertGreaterThan (option.cpuLoad, 0.0);
+    XCTAssertLessThan (option.cpuLoad, option.effectiveCPUBudgetPolicy.fraction);
+    option.currentValue = NO;
+}
+
+- (void) testWorkloadOverBudgetIsTurnedOff
+{
+    PWDebugSwitchOption* option = [self.budgetGroup optionWithTitle:@"Heavy Tracing"];
+    PWDebugCounterReset (&PWDebugOptionTestHeavyTracing_CPUTime);
+    option.currentValue = YES;
+    uint64_t startTime = PWDebugMonotonicNanoseconds ();
+
+    // About 80 % of the time in the guarded scope, the budget is 10 %.
+    dispatch_group_t workload = [self startWorkload:^{
+        if (DEBUG_OPTION_ACTIVE (PWDebugOptionTestHeavyTracing)) {
+            DEBUG_OPTION_MEASURE_CPU (PWDebugOptionTestHeavyTracing);
+            PWSpin (4000);
+        }
+        usleep (1000);
+    }];
+
+    [self expectationForNotification:PWDebugOptionCPUBudgetExceededNotification object:option
+                             handler:^BOOL (NSNotification* notification) {
+                                 return [notification.userInfo[PWDebugOptionCPULoadKey] doubleValue] > 0.1;
+                             }];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    XCTAssertFalse (option.currentValue);
+    XCTAssertFalse (DEBUG_OPTION_ACTIVE (PWDebugOptionTestHeavyTracing));
+
+    // Once off, the workload does not enter the guarded scope anymore, which bounds the total overhead.
+    int64_t spentAtTrip = PWDebugCounterValue (&PWDebugOptionTestHeavyTracing_CPUTime);
+    usleep (500000);
+    [self stopWorkload:workload];
+    int64_t spent = PWDebugCounterValue (&PWDebugOptionTestHeavyTracing_CPUTime);
+    XCTAssertLessThanOrEqual (spent - spentAtTrip, (int64_t)(4000 * NSEC_PER_USEC));  // at most one scope in flight
+
+    // The switch is judged after a full window, so the workload cannot spend much more than one window in the scope.
+    NSTimeInterval window = option.effectiveCPUBudgetPolicy.window;
+    XCTAssertLessThan (spent, (int64_t)(1.5 * window * NSEC_PER_SEC));
+    XCTAssertGreaterThan (PWDebugMonotonicNanoseconds () - startTime, (uint64_t)(window * NSEC_PER_SEC));
+}
+
+@end
@@ -0,0 +1,163 @@
+//
+//  PWDebugOptionFileStoreTest.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <XCTest/XCTest.h>
+#import "PWDebugOptionFileStore.h"
+
+@interface PWDebugOptionFileStoreTest : XCTestCase
+@end
+
+// Same CRC-32 as the store, for writing records by hand.
+static uint32_t PWTestCRC32 (const uint8_t* bytes, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+@implementation PWDebugOptionFileStoreTest
+{
+    NSString* _directory;
+}
+
+- (void) setUp
+{
+    [super setUp];
+    _directory = [NSTemporaryDirectory () stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    [NSFileManager.defaultManager createDirectoryAtPath:_directory withIntermediateDirectories:YES
+                                             attributes:nil error:NULL];
+}
+
+- (void) tearDown
+{
+    [NSFileManager.defaultManager removeItemAtPath:_directory error:NULL];
+    [super tearDown];
+}
+
+/// There is one store per path in a process, therefore a copy of the file stands in for a relaunch.
+- (PWDebugOptionFileStore*) reopenStore:(PWDebugOptionFileStore*)store
+{
+    NSString* copyPath = [_directory stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    XCTAssertTrue ([NSFileManager.defaultManager copyItemAtPath:store.path toPath:copyPath error:NULL]);
+    NSError* error;
+    PWDebugOptionFileStore* copy = [PWDebugOptionFileStore storeWithPath:copyPath error:&error];
+    XCTAssertNotNil (copy, @"%@", error);
+    return copy;
+}
+
+- (void) testRoundTrip
+{
+    NSString* path = [_directory stringByAppendingPathComponent:@"options.store"];
+    PWDebugOptionFileStore* store = [PWDebugOptionFileStore storeWithPath:path error:NULL];
+    XCTAssertNotNil (store);
+    XCTAssertEqual ([PWDebugOptionFileStore storeWithPath:path error:NULL], store);
+
+    [store setObject:@YES forKey:@"switch"];
+    [store setObject:@(-42) forKey:@"enum"];
+    [store setObject:@"Grüße" forKey:@"text"];
+    [store setObject:@"gone" forKey:@"removed"];
+    [store removeObjectForKey:@"removed"];
+    XCTAssertTrue ([store synchronize]);
+
+    PWDebugOptionFileStore* reopened = [self reopenStore:store];
+    XCTAssertEqualObjects ([reopened objectForKey:@"switch"], @1);
+    XCTAssertEqualObjects ([reopened objectForKey:@"enum"], @(-42));
+    XCTAssertEqualObjects ([reopened objectForKey:@"text"], @"Grüße");
+    XCTAssertNil ([reopened objectForKey:@"removed"]);
+    XCTAssertEqual (reopened.count, 3);
+}
+
+- (void) testTornRecordIsDropped
+{
+    NSString* path = [_directory stringByAppendingPathComponent:@"torn.store"];
+    PWDebugOptionFileStore* store = [PWDebugOptionFileStore storeWithPath:path error:NULL];
+    [store setObject:@1 forKey:@"first"];
+    [store setObject:@2 forKey:@"second"];
+    [store synchronize];
+
+    // Simulate a crash in the middle of appending the second record.
+    NSFileHandle* handle = [NSFileHandle fileHandleForWritingAtPath:path];
+    unsigned long long size = [handle seekToEndOfFile];
+    [handle truncateFileAtOffset:size - 3];
+    [handle closeFile];
+
+    PWDebugOptionFileStore* reopened = [self reopenStore:store];
+    XCTAssertEqualObjects ([reopened objectForKey:@"first"], @1);
+    XCTAssertNil ([reopened objectForKey:@"second"]);
+
+    // The torn tail is cut off, new records are readable again.
+    [reopened setObject:@3 forKey:@"third"];
+    PWDebugOptionFileStore* again = [self reopenStore:reopened];
+    XCTAssertEqualObjects ([again objectForKey:@"first"], @1);
+    XCTAssertEqualObjects ([again objectForKey:@"third"], @3);
+}
+
+- (void) testMalformedRemoveRecordIsRejected
+{
+    NSString* path = [_directory stringByAppendingPathComponent:@"malformed.store"];
+    PWDebugOptionFileStore* store = [PWDebugOptionFileStore storeWithPath:path error:NULL];
+    [store setObject:@1 forKey:@"first"];
+    [store synchronize];
+
+    // A remove record for "first" with a value, which remove records never have. The CRC is valid.
+    const uint8_t payload[] = { 0 /* remove */, 5, 0, 'f', 'i', 'r', 's', 't', 42 };
+    uint32_t crc = PWTestCRC32 (payload, sizeof payload);
+    const uint8_t recordHeader[] = { sizeof payload, 0, 0, 0,
+                                     (uint8_t)crc, (uint8_t)(crc >> 8), (uint8_t)(crc >> 16), (uint8_t)(crc >> 24) };
+    NSFileHandle* handle = [NSFileHandle fileHandleForWritingAtPath:path];
+    [handle seekToEndOfFile];
+    [handle writeData:[NSData dataWithBytes:recordHeader length:sizeof recordHeader]];
+    [handle writeData:[NSData dataWithBytes:payload length:sizeof payload]];
+    [handle closeFile];
+
+    PWDebugOptionFileStore* reopened = [self reopenStore:store];
+    XCTAssertEqualObjects ([reopened objectForKey:@"first"], @1);
+    XCTAssertEqual (reopened.recordCount, 1);
+}
+
+- (void) testCompaction
+{
+    NSString* path = [_directory stringByAppendingPathComponent:@"compact.store"];
+    PWDebugOptionFileStore* store = [PWDebugOptionFileStore storeWithPath:path error:NULL];
+    for (NSInteger i = 0; i < 1000; ++i)
+        [store setObject:@(i) forKey:(i % 2) ? @"odd" : @"even"];
+
+    // Compaction kept the file from growing with the number of changes.
+    XCTAssertEqual (store.count, 2);
+    XCTAssertLessThan (store.recordCount, 100);
+    XCTAssertFalse ([NSFileManager.defaultManager fileExistsAtPath:[path stringByAppendingString:@".compacting"]]);
+
+    XCTAssertTrue ([store compact:NULL]);
+    XCTAssertEqual (store.recordCount, 2);
+
+    PWDebugOptionFileStore* reopened = [self reopenStore:store];
+    XCTAssertEqualObjects ([reopened objectForKey:@"even"], @998);
+    XCTAssertEqualObjects ([reopened objectForKey:@"odd"], @999);
+    XCTAssertEqual (reopened.recordCount, 2);
+}
+
+- (void) testSuites
+{
+    NSString* path = [_directory stringByAppendingPathComponent:@"options.store"];
+    PWDebugOptionFileStore* store = [PWDebugOptionFileStore storeWithPath:path error:NULL];
+    PWDebugOptionFileStore* suite = (PWDebugOptionFileStore*)[store storeForSuiteName:@"group.test"];
+    XCTAssertNotEqual (suite, store);
+    XCTAssertEqualObjects (suite.path.lastPathComponent, @"options.group.test.store");
+
+    [suite setObject:@7 forKey:@"key"];
+    XCTAssertNil ([store objectForKey:@"key"]);
+}
+
+@end
@@ -0,0 +1,162 @@
+//
+//  PWDebugOptionSearchIndexTest.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <XCTest/XCTest.h>
+#import "PWDebugOptionMacros.h"
+#import "PWDebugOptionSearchIndex.h"
+
+@interface PWDebugOptionSearchIndexTest : XCTestCase
+@end
+
+DEBUG_OPTION_DECLARE_GROUP (TestSearchGroup)
+DEBUG_OPTION_DEFINE_GROUP (TestSearchGroup, PWRootDebugOptionGroup,
+                           @"Search Group", @"A group for testing the search index")
+
+DEBUG_OPTION_DECLARE_GROUP (TestSearchRenderingGroup)
+DEBUG_OPTION_DEFINE_GROUP (TestSearchRenderingGroup, TestSearchGroup,
+                           @"Rendering", nil)
+
+DEBUG_OPTION_SWITCH (PWDebugOptionTestSearchSwitch1, TestSearchGroup,
+                     @"Log Cache Misses", @"Logs every miss of the thumbnail cache",
+                     DEBUG_OPTION_DEFAULT_OFF, DEBUG_OPTION_NON_PERSISTENT)
+
+DEBUG_OPTION_SWITCH (PWDebugOptionTestSearchSwitch2, TestSearchRenderingGroup,
+                     @"Draw Layout Frames", @"Outlines all views",
+                     DEBUG_OPTION_DEFAULT_OFF, DEBUG_OPTION_NON_PERSISTENT)
+
+DEBUG_OPTION_SWITCH (PWDebugOptionTestSearchSwitch3, TestSearchRenderingGroup,
+                     @"Überblendung zeigen", nil,
+                     DEBUG_OPTION_DEFAULT_OFF, DEBUG_OPTION_NON_PERSISTENT)
+
+static _Atomic (BOOL) sLateSwitch;
+static _Atomic (BOOL) sBackgroundSwitch;
+
+
+@implementation PWDebugOptionSearchIndexTest
+
+- (PWDebugOptionSearchIndex*) searchIndex
+{
+    return [PWDebugOptionSearchIndex searchIndexForRootGroup:PWRootDebugOptionGroup.sharedRootGroup];
+}
+
+- (NSArray<NSString*>*) titlesForQuery:(NSString*)query
+{
+    return [[self.searchIndex resultsForQuery:query] valueForKeyPath:@"option.title"];
+}
+
+- (void) testSharedIndex
+{
+    XCTAssertEqual (self.searchIndex, self.searchIndex);
+    XCTAssertGreaterThan (self.searchIndex.count, 0);
+}
+
+- (void) testSubstringAndPrefixMatches
+{
+    XCTAssertEqualObjects ([self titlesForQuery:@"cache"], @[@"Log Cache Misses"]);
+    XCTAssertEqualObjects ([self titlesForQuery:@"ACHE MIS"], @[@"Log Cache Misses"]);   // substrings, any case
+    XCTAssertEqualObjects ([self titlesForQuery:@"thumbnail"], @[@"Log Cache Misses"]);   // tool tip
+    XCTAssertEqualObjects ([self titlesForQuery:@"la fr"], @[@"Draw Layout Frames"]);     // short words are prefixes
+    XCTAssertEqualObjects ([self titlesForQuery:@"ay"], @[]);                             // not a prefix
+    XCTAssertEqualObjects ([self titlesForQuery:@"uberblend"], @[@"Überblendung zeigen"]); // diacritics
+    XCTAssertEqualObjects ([self titlesForQuery:@"cache frames"], @[]);                   // all words must match
+    XCTAssertEqualObjects ([self titlesForQuery:@""], @[]);
+}
+
+- (void) testPathMatches
+{
+    NSArray<PWDebugOptionSearchResult*>* results = [self.searchIndex resultsForQuery:@"rendering frames"];
+    XCTAssertEqual (results.count, 1);
+    XCTAssertEqualObjects (results.firstObject.path, (@[@"Search Group", @"Rendering"]));
+
+    NSArray<NSString*>* titles = [self titlesForQuery:@"search group rendering"];
+    XCTAssertTrue ([titles containsObject:@"Rendering"]);
+    XCTAssertTrue ([titles containsObject:@"Draw Layout Frames"]);
+    XCTAssertTrue ([titles containsObject:@"Überblendung zeigen"]);
+}
+
+- (void) testIncrementalUpdate
+{
+    PWDebugOptionSearchIndex* index = self.searchIndex;
+    NSUInteger count = index.count;
+    XCTAssertEqualObjects ([self titlesForQuery:@"late arrival"], @[]);
+
+    // Added to a group which is not the last one in the tree.
+    PWDebugOptionGroup* searchGroup = [[PWRootDebugOptionGroup.sharedRootGroup optionWithTitle:@"Search Group"] subGroup];
+    PWDebugOptionGroup* renderingGroup = [[searchGroup optionWithTitle:@"Rendering"] subGroup];
+    [renderingGroup addOption:[[PWDebugSwitchOption alloc] initWithTitle:@"Late Arrival" toolTip:nil
+                                                           booleanTarget:&sLateSwitch defaultValue:NO
+                                                       defaultsKeySuffix:nil]];
+
+    XCTAssertEqual (index.count, count + 1);
+    NSArray<PWDebugOptionSearchResult*>* results = [index resultsForQuery:@"late arrival"];
+    XCTAssertEqual (results.count, 1);
+    XCTAssertEqual (results.firstObject.group, renderingGroup);
+
+    // Results are in tree order: the late option follows the other options of its group, not the whole tree.
+    NSArray<NSString*>* titles = [self titlesForQuery:@"search group"];
+    NSUInteger lateIndex = [titles indexOfObject:@"Late Arrival"];
+    NSUInteger lastRenderingIndex = MAX ([titles indexOfObject:@"Draw Layout Frames"],
+                                         [titles indexOfObject:@"Überblendung zeigen"]);
+    XCTAssertEqual (lateIndex, lastRenderingIndex + 1);
+}
+
+- (void) testSortingChangesResultOrder
+{
+    PWDebugOptionGroup* searchGroup = [[PWRootDebugOptionGroup.sharedRootGroup optionWithTitle:@"Search Group"] subGroup];
+    PWDebugOptionGroup* renderingGroup = [[searchGroup optionWithTitle:@"Rendering"] subGroup];
+    NSArray<NSString*>* expected = @[@"Draw Layout Frames", @"Überblendung zeigen"];
+    NSPredicate* renderingTitles = [NSPredicate predicateWithFormat:@"SELF IN %@", expected];
+
+    [renderingGroup sortOptionsUsingComparator:^NSComparisonResult (PWDebugOption* lhs, PWDebugOption* rhs) {
+        return [lhs.title compare:rhs.title];
+    }];
+    NSArray<NSString*>* titles = [self titlesForQuery:@"search group rendering"];
+    XCTAssertEqualObjects ([titles filteredArrayUsingPredicate:renderingTitles], expected);
+
+    // The cached tree order follows the next sort.
+    [renderingGroup sortOptionsUsingComparator:^NSComparisonResult (PWDebugOption* lhs, PWDebugOption* rhs) {
+        return [rhs.title compare:lhs.title];
+    }];
+    titles = [self titlesForQuery:@"search group rendering"];
+    XCTAssertEqualObjects ([titles filteredArrayUsingPredicate:renderingTitles],
+                           expected.reverseObjectEnumerator.allObjects);
+
+    [renderingGroup sortOptionsUsingComparator:^NSComparisonResult (PWDebugOption* lhs, PWDebugOption* rhs) {
+        return [lhs.title compare:rhs.title];
+    }];
+}
+
+- (void) testOptionAddedOnBackgroundThread
+{
+    PWDebugOptionSearchIndex* index = self.searchIndex;
+    NSUInteger count = index.count;
+    PWDebugOptionGroup* searchGroup = [[PWRootDebugOptionGroup.sharedRootGroup optionWithTitle:@"Search Group"] subGroup];
+
+    XCTestExpectation* added = [self expectationWithDescription:@"added"];
+    dispatch_async (dispatch_get_global_queue (QOS_CLASS_UTILITY, 0), ^{
+        [searchGroup addOption:[[PWDebugSwitchOption alloc] initWithTitle:@"Background Arrival" toolTip:nil
+                                                            booleanTarget:&sBackgroundSwitch defaultValue:NO
+                                                        defaultsKeySuffix:nil]];
+        [added fulfill];
+    });
+    [self waitForExpectations:@[added] timeout:5.0];
+
+    // The index catches up on the main queue.
+    XCTestExpectation* indexed = [self expectationWithDescription:@"indexed"];
+    dispatch_async (dispatch_get_main_queue (), ^{
+        [indexed fulfill];
+    });
+    [self waitForExpectations:@[indexed] timeout:5.0];
+    XCTAssertEqual (index.count, count + 1);
+    XCTAssertEqualObjects ([self titlesForQuery:@"background arrival"], @[@"Background Arrival"]);
+}
+
+@end
@@ -0,0 +1,130 @@
+//
+//  PWDebugOptionsPerformanceTest.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <XCTest/XCTest.h>
+#import "PWDebugOptionMacros.h"
+
+/// Contention benchmarks: many threads reading a switch while another thread writes occasionally, or while another
+/// thread hammers data which may share a cache line with the switch.
+@interface PWDebugOptionsPerformanceTest : XCTestCase
+@end
+
+DEBUG_OPTION_SWITCH (PWDebugOptionContentionSwitch, PWRootDebugOptionGroup,
+                     @"Contention Switch", @"A switch for the contention benchmarks",
+                     DEBUG_OPTION_DEFAULT_OFF, DEBUG_OPTION_NON_PERSISTENT)
+
+// Models the situation the dedicated option section avoids: a switch sharing its cache line with a hot counter.
+static struct {
+    _Atomic (int64_t)   hotCounter;
+    _Atomic (BOOL)      flag;
+} sSharedLine;
+
+static _Atomic (int64_t) sHotCounter;
+
+static _Atomic (BOOL) sStopWriter;
+
+static _Atomic (NSUInteger) sReadSink;
+
+static const NSUInteger ReadsPerReader = 2000000;
+
+@implementation PWDebugOptionsPerformanceTest
+
+- (PWDebugSwitchOption*) contentionSwitchOption
+{
+    PWDebugSwitchOption* option = [PWRootDebugOptionGroup.sharedRootGroup optionWithTitle:@"Contention Switch"];
+    XCTAssertNotNil (option);
+    return option;
+}
+
+/// Runs 'readerLoop' on all but one processors while 'writerStep' is repeated on the remaining one, pausing
+/// 'writerInterval' microseconds between steps.
+- (void) measureReaderLoop:(void (^) (void))readerLoop
+                writerStep:(void (^) (void))writerStep
+            writerInterval:(useconds_t)writerInterval
+{
+    NSUInteger readerCount = MAX (NSProcessInfo.processInfo.activeProcessorCount, 2) - 1;
+    dispatch_queue_t queue = dispatch_get_global_queue (QOS_CLASS_USER_INITIATED, 0);
+
+    [self measureBlock:^{
+        dispatch_group_t writerGroup = dispatch_group_create ();
+        dispatch_group_async (writerGroup, queue, ^{
+            while (!sStopWriter) {
+                writerStep ();
+                if (writerInterval > 0)
+                    usleep (writerInterval);
+            }
+        });
+
+        dispatch_apply (readerCount, queue, ^(size_t iteration) {
+            readerLoop ();
+        });
+
+        sStopWriter = YES;
+        dispatch_group_wait (writerGroup, DISPATCH_TIME_FOREVER);
+        sStopWriter = NO;
+    }];
+}
+
+- (void) testRelaxedReadsWithOccasionalWriter
+{
+    PWDebugSwitchOption* option = self.contentionSwitchOption;
+
+    [self measureReaderLoop:^{
+        NSUInteger count = 0;
+        for (NSUInteger i = 0; i < ReadsPerReader; ++i)
+            count += DEBUG_OPTION_READ (PWDebugOptionContentionSwitch);
+        sReadSink += count;
+    } writerStep:^{
+        option.currentValue = !option.currentValue;
+    } writerInterval:1000];
+}
+
+- (void) testSequentiallyConsistentReadsWithOccasionalWriter
+{
+    PWDebugSwitchOption* option = self.contentionSwitchOption;
+
+    [self measureReaderLoop:^{
+        NSUInteger count = 0;
+        for (NSUInteger i = 0; i < ReadsPerReader; ++i)
+            count += PWDebugOptionContentionSwitch;
+        sReadSink += count;
+    } writerStep:^{
+        option.currentValue = !option.currentValue;
+    } writerInterval:1000];
+}
+
+- (void) testReadsNextToHotCounterInSharedLine
+{
+    [self measureReaderLoop:^{
+        NSUInteger count = 0;
+        for (NSUInteger i = 0; i < ReadsPerReader; ++i)
+            count += atomic_load_explicit (&sSharedLine.flag, memory_order_relaxed);
+        sReadSink += count;
+    } writerStep:^{
+        for (int i = 0; i < 1000; ++i)
+            atomic_fetch_add_explicit (&sSharedLine.hotCounter, 1, memory_order_relaxed);
+    } writerInterval:0];
+}
+
+- (void) testReadsOfIsolatedSwitchWithHotCounter
+{
+    [self measureReaderLoop:^{
+        NSUInteger count = 0;
+        for (NSUInteger i = 0; i < ReadsPerReader; ++i)
+            count += DEBUG_OPTION_READ (PWDebugOptionContentionSwitch);
+        sReadSink += count;
+    } writerStep:^{
+        for (int i = 0; i < 1000; ++i)
+            atomic_fetch_add_explicit (&sHotCounter, 1, memory_order_relaxed);
+    } writerInterval:0];
+}
+
+@end
@@ -11,6 +11,7 @@
 
 #import <XCTest/XCTest.h>
 #import "PWDebugOptionMacros.h"
+#import "PWDebugOptionFileStore.h"
 
 @interface PWDebugOptionsTest : XCTestCase
 @end
@@ -24,7 +25,28 @@ DEBUG_OPTION_ACTIONBLOCK (PWDebugOptionTestActionBlock, PWRootDebugOptionGroup,
                           @"A block-based action for testing",
                           ^{ ++sAction1Count; })
 
+static _Atomic (int) sAsyncAction1Count = 0;
+DEBUG_OPTION_ASYNC_ACTIONBLOCK (PWDebugOptionTestAsyncActionBlock, PWRootDebugOptionGroup, @"Async Action 1",
+                                @"An asynchronous block-based action for testing",
+                                ^(NSProgress* progress) {
+                                    progress.totalUnitCount = 10;
+                                    for (int i = 0; i < 10 && !progress.cancelled; ++i) {
+                                        usleep (10000);
+                                        progress.completedUnitCount = i + 1;
+                                    }
+                                    ++sAsyncAction1Count;
+                                })
+
+DEBUG_OPTION_ASYNC_ACTIONBLOCK (PWDebugOptionTestCancellableAction, PWRootDebugOptionGroup, @"Async Action 2",
+                                @"An asynchronous action which runs until cancelled",
+                                ^(NSProgress* progress) {
+                                    while (!progress.cancelled)
+                                        usleep (1000);
+                                })
+
 DEBUG_OPTION_DECLARE_GROUP (TestDebugSubGroup)
+
+DEBUG_DECLARE_COUNTER (PWDebugOptionTestCounter2)
 DEBUG_OPTION_DEFINE_GROUP (TestDebugSubGroup, PWRootDebugOptionGroup,
                            @"Sub group 1", @"A sub group for testing")
 
@@ -34,6 +56,21 @@ DEBUG_OPTION_DEFINE_SWITCH (PWDebugOptionTestSwitch2, TestDebugSubGroup,
                             @"Switch 2", @"A test switch in a sub group",
                             DEBUG_OPTION_PERSISTENT)
 
+DEBUG_OPTION_DECLARE_GROUP (TestDebugNestedGroup)
+DEBUG_OPTION_DEFINE_GROUP (TestDebugNestedGroup, TestDebugSubGroup,
+                           @"Nested group", @"A sub group of a sub group for testing")
+
+DEBUG_OPTION_SWITCH (PWDebugOptionTestSwitch3, TestDebugNestedGroup,
+                     @"Switch 3", @"A test switch in a nested group",
+                     DEBUG_OPTION_DEFAULT_ON, DEBUG_OPTION_NON_PERSISTENT)
+
+
+DEBUG_COUNTER (PWDebugOptionTestCounter1, PWRootDebugOptionGroup,
+               @"Counter 1", @"A counter for testing")
+
+DEBUG_DEFINE_COUNTER (PWDebugOptionTestCounter2, TestDebugSubGroup,
+                      @"Counter 2", @"A test counter in a sub group")
+
 
 typedef NS_ENUM(NSInteger, PWTestEnum) {
     PWTestValue1,
@@ -50,6 +87,21 @@ DEBUG_OPTION_ENUM (PWDebugOptionTestEnum, PWRootDebugOptionGroup,
                    nil)
 
 
+DEBUG_OPTION_SWITCH (PWDebugOptionTestExpiringSwitch, PWRootDebugOptionGroup,
+                     @"Expiring Switch", @"A switch which turns itself off after half a second",
+                     DEBUG_OPTION_DEFAULT_OFF, DEBUG_OPTION_PERSISTENT)
+
+DEBUG_OPTION_EXPIRY (PWDebugOptionTestExpiringSwitch, PWRootDebugOptionGroup, 0.5, 0)
+
+DEBUG_OPTION_ENUM (PWDebugOptionTestExpiringEnum, PWRootDebugOptionGroup,
+                   @"Expiring Enum", @"An enumeration which reverts after 100 evaluations", DEBUG_OPTION_ENUM_INLINE,
+                   PWTestEnum, PWTestValue1, DEBUG_OPTION_NON_PERSISTENT,
+                   @"Value 1", PWTestValue1,
+                   @"Value 2", PWTestValue2,
+                   nil)
+
+DEBUG_OPTION_EXPIRY (PWDebugOptionTestExpiringEnum, PWRootDebugOptionGroup, 0, 100)
+
 
 DEBUG_OPTION_TEXT (PWDebugOptionTestText1, PWRootDebugOptionGroup,
                    @"Text 1", @"A text for testing",
@@ -80,7 +132,7 @@ DEBUG_OPTION_DEFINE_TEXT (PWDebugOptionTestText2, PWRootDebugOptionGroup,
     //STAssertEquals (rootGroup.options.count, 7, nil);   // includes PWLogCalculationOfDerivedPropertyWithKey
                                                           
     PWDebugOptionSubGroup* subGroup = [rootGroup optionWithTitle:@"Sub group 1"];
-    XCTAssertEqual (subGroup.subGroup.options.count, 1);
+    XCTAssertEqual (subGroup.subGroup.options.count, 3);
     
     PWDebugEnumOption* enumOption = [rootGroup optionWithTitle:@"Test Enum"];
     XCTAssertTrue (enumOption.asSubMenu);
@@ -104,6 +156,223 @@ DEBUG_OPTION_DEFINE_TEXT (PWDebugOptionTestText2, PWRootDebugOptionGroup,
     XCTAssertEqual (sAction1Count, 1);
 }
 
+- (void) testAsyncActionBlockOption
+{
+    PWRootDebugOptionGroup* rootGroup = PWRootDebugOptionGroup.sharedRootGroup;
+
+    PWDebugAsyncActionBlockOption* actionOption = [rootGroup optionWithTitle:@"Async Action 1"];
+    XCTAssertNotNil (actionOption);
+    XCTAssertFalse (actionOption.isRunning);
+    sAsyncAction1Count = 0;
+
+    XCTNSNotificationExpectation* finished
+    = [[XCTNSNotificationExpectation alloc] initWithName:PWDebugAsyncActionOptionRunningStateDidChangeNotification
+                                                  object:actionOption];
+    finished.handler = ^BOOL (NSNotification* notification) {
+        return !actionOption.isRunning;
+    };
+
+    [actionOption execute:nil];
+    XCTAssertTrue (actionOption.isRunning);
+    XCTAssertNotNil (actionOption.progress);
+
+    // A second execute while running must not start another run.
+    [actionOption execute:nil];
+
+    [self waitForExpectations:@[finished] timeout:5.0];
+    XCTAssertEqual (sAsyncAction1Count, 1);
+    XCTAssertNil (actionOption.progress);
+    XCTAssertGreaterThan (actionOption.lastExecutionDuration, 0.0);
+}
+
+- (void) testAsyncActionCancellation
+{
+    PWRootDebugOptionGroup* rootGroup = PWRootDebugOptionGroup.sharedRootGroup;
+
+    PWDebugAsyncActionBlockOption* actionOption = [rootGroup optionWithTitle:@"Async Action 2"];
+    XCTAssertNotNil (actionOption);
+
+    XCTNSNotificationExpectation* finished
+    = [[XCTNSNotificationExpectation alloc] initWithName:PWDebugAsyncActionOptionRunningStateDidChangeNotification
+                                                  object:actionOption];
+    finished.handler = ^BOOL (NSNotification* notification) {
+        return !actionOption.isRunning;
+    };
+
+    [actionOption execute:nil];
+    XCTAssertTrue (actionOption.isRunning);
+    [actionOption cancel];
+
+    [self waitForExpectations:@[finished] timeout:5.0];
+    XCTAssertFalse (actionOption.isRunning);
+}
+
+- (void) testCounterOption
+{
+    PWRootDebugOptionGroup* rootGroup = PWRootDebugOptionGroup.sharedRootGroup;
+
+    PWDebugCounterOption* counterOption = [rootGroup optionWithTitle:@"Counter 1"];
+    XCTAssertNotNil (counterOption);
+    XCTAssertEqual (counterOption.counter, &PWDebugOptionTestCounter1);
+    [rootGroup resetCounters];
+
+    // Count from many threads, which are spread over the shards.
+    dispatch_apply (64, dispatch_get_global_queue (QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        for (int i = 0; i < 1000; ++i)
+            DEBUG_COUNTER_INCREMENT (PWDebugOptionTestCounter1);
+        DEBUG_COUNTER_ADD (PWDebugOptionTestCounter2, 2);
+    });
+    XCTAssertEqual (counterOption.value, 64000);
+
+    NSDictionary<NSString*, NSNumber*>* snapshot = rootGroup.counterSnapshot;
+    XCTAssertEqualObjects (snapshot[@"PWDebugOptionTestCounter1"], @64000);
+    XCTAssertEqualObjects (snapshot[@"PWDebugOptionTestCounter2"], @128);
+
+    [counterOption reset];
+    XCTAssertEqual (counterOption.value, 0);
+    XCTAssertEqual (PWDebugCounterValue (&PWDebugOptionTestCounter2), 128);
+
+    [rootGroup resetCounters];
+    XCTAssertEqual (PWDebugCounterValue (&PWDebugOptionTestCounter2), 0);
+}
+
+- (void) testGroupEnabledState
+{
+    PWRootDebugOptionGroup* rootGroup = PWRootDebugOptionGroup.sharedRootGroup;
+
+    PWDebugOptionGroup* subGroup = [[rootGroup optionWithTitle:@"Sub group 1"] subGroup];
+    PWDebugOptionGroup* nestedGroup = [[subGroup optionWithTitle:@"Nested group"] subGroup];
+    XCTAssertEqual (nestedGroup.parentGroup, subGroup);
+    XCTAssertEqual (subGroup.parentGroup, rootGroup);
+    XCTAssertNil (rootGroup.parentGroup);
+
+    PWDebugSwitchOption* switchOption = [subGroup optionWithTitle:@"Switch 2"];
+    switchOption.currentValue = YES;
+    XCTAssertTrue (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch2));
+    XCTAssertTrue (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch3));
+
+    __block NSUInteger notificationCount = 0;
+    id observer = [NSNotificationCenter.defaultCenter addObserverForName:PWDebugOptionGroupEnabledStateDidChangeNotification
+                                                                  object:subGroup
+                                                                   queue:nil
+                                                              usingBlock:^(NSNotification* notification) {
+                                                                  ++notificationCount;
+                                                              }];
+
+    // Disabling a group masks all descendants, but leaves their values alone.
+    subGroup.isEnabled = NO;
+    XCTAssertEqual (notificationCount, 1);
+    XCTAssertFalse (subGroup.isEffectivelyEnabled);
+    XCTAssertFalse (nestedGroup.isEffectivelyEnabled);
+    XCTAssertTrue (nestedGroup.isEnabled);
+    XCTAssertFalse (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch2));
+    XCTAssertFalse (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch3));
+    XCTAssertTrue (PWDebugOptionTestSwitch2);
+    XCTAssertTrue (PWDebugOptionTestSwitch3);
+
+    // Changes of masked options take effect when the group is enabled again.
+    switchOption.currentValue = NO;
+    XCTAssertFalse (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch2));
+    switchOption.currentValue = YES;
+    XCTAssertFalse (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch2));
+
+    // A disabled nested group stays masked when its parent is enabled again.
+    nestedGroup.isEnabled = NO;
+    subGroup.isEnabled = YES;
+    XCTAssertEqual (notificationCount, 2);
+    XCTAssertTrue (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch2));
+    XCTAssertFalse (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch3));
+
+    nestedGroup.isEnabled = YES;
+    XCTAssertTrue (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch3));
+
+    // Setting the same state again does not notify.
+    subGroup.isEnabled = YES;
+    XCTAssertEqual (notificationCount, 2);
+
+    [NSNotificationCenter.defaultCenter removeObserver:observer];
+    switchOption.currentValue = NO;
+}
+
+- (void) testGroupEnabledStatePersistence
+{
+    NSString* path = [NSTemporaryDirectory () stringByAppendingPathComponent:
+                      [NSUUID.UUID.UUIDString stringByAppendingPathExtension:@"store"]];
+    PWDebugOptionFileStore* store = [PWDebugOptionFileStore storeWithPath:path error:NULL];
+    XCTAssertNotNil (store);
+
+    // Disable and save a group tree which uses the store.
+    PWDebugOptionGroup* savedGroup = [[TestDebugSubGroup alloc] initWithUserDefaultsSuiteName:nil];
+    [savedGroup loadStateFromStore:store];
+    savedGroup.isEnabled = NO;
+    [savedGroup saveState];
+    XCTAssertEqualObjects ([store objectForKey:@"DebugOptionGroup_TestDebugSubGroup"], @NO);
+
+    // A fresh tree loaded from the store comes up disabled and masks the options of its descendants.
+    PWDebugOptionGroup* loadedGroup = [[TestDebugSubGroup alloc] initWithUserDefaultsSuiteName:nil];
+    XCTAssertTrue (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch3));
+    [loadedGroup loadStateFromStore:store];
+    XCTAssertFalse (loadedGroup.isEnabled);
+    XCTAssertFalse (loadedGroup.isEffectivelyEnabled);
+    XCTAssertTrue (PWDebugOptionTestSwitch3);
+    XCTAssertFalse (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch3));
+
+    loadedGroup.isEnabled = YES;
+    XCTAssertTrue (DEBUG_OPTION_ACTIVE (PWDebugOptionTestSwitch3));
+    [NSFileManager.defaultManager removeItemAtPath:path error:NULL];
+}
+
+- (void) testExpiryByTime
+{
+    PWDebugSwitchOption* switchOption = [PWRootDebugOptionGroup.sharedRootGroup optionWithTitle:@"Expiring Switch"];
+    XCTAssertEqual (switchOption.expiryInterval, 0.5);
+    XCTAssertFalse (switchOption.isExpiring);
+
+    switchOption.currentValue = YES;
+    XCTAssertTrue (switchOption.isExpiring);
+    XCTAssertGreaterThan (switchOption.remainingExpiryInterval, 0.0);
+    XCTAssertLessThanOrEqual (switchOption.remainingExpiryInterval, 0.5);
+
+    // The temporary value is not saved.
+    [switchOption saveState];
+    XCTAssertNil ([switchOption.store objectForKey:switchOption.defaultsKey]);
+
+    [self expectationForNotification:PWDebugOptionDidChangeNotification object:switchOption handler:nil];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertFalse (PWDebugOptionTestExpiringSwitch);
+    XCTAssertFalse (switchOption.isExpiring);
+    XCTAssertEqual (switchOption.remainingExpiryInterval, 0.0);
+}
+
+- (void) testExpiryByEvaluations
+{
+    PWDebugEnumOption* enumOption = [PWRootDebugOptionGroup.sharedRootGroup optionWithTitle:@"Expiring Enum"];
+
+    // Evaluations of the default value don’t count.
+    for (int i = 0; i < 200; ++i)
+        (void) DEBUG_OPTION_EVALUATE (PWDebugOptionTestExpiringEnum);
+    XCTAssertFalse (enumOption.isExpiring);
+
+    enumOption.currentValue = PWTestValue2;
+    XCTAssertEqual (enumOption.remainingExpiryEvaluations, 100);
+    dispatch_apply (10, dispatch_get_global_queue (QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        for (int i = 0; i < 9; ++i)
+            XCTAssertEqual (DEBUG_OPTION_EVALUATE (PWDebugOptionTestExpiringEnum), PWTestValue2);
+    });
+    XCTAssertEqual (enumOption.remainingExpiryEvaluations, 10);
+
+    // Setting a value restarts the countdown.
+    enumOption.currentValue = PWTestValue2;
+    XCTAssertEqual (enumOption.remainingExpiryEvaluations, 100);
+
+    [self expectationForNotification:PWDebugOptionDidChangeNotification object:enumOption handler:nil];
+    for (int i = 0; i < 100; ++i)
+        (void) DEBUG_OPTION_EVALUATE (PWDebugOptionTestExpiringEnum);
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual (enumOption.currentValue, PWTestValue1);
+    XCTAssertFalse (enumOption.isExpiring);
+}
+
 - (void) testDebugOptionKVObservation
 {
     PWRootDebugOptionGroup* rootGroup = PWRootDebugOptionGroup.sharedRootGroup;
@@ -0,0 +1,71 @@
+//
+//  PWDebugTimerWheelTest.m
+//  DebugOptionsFoundation
+//
+//  Created by Kai Bruening on 19.10.26.
+//  Copyright © 2026 ProjectWizards GmbH. All rights reserved.
+//
+//  You may incorporate this code into your program(s) without restriction. This code has been
+//  provided “AS IS” and the responsibility for its operation is yours.
+//
+
+#import <XCTest/XCTest.h>
+#import "PWDebugTimerWheel.h"
+
+@interface PWDebugTimerWheelTest : XCTestCase
+@end
+
+@implementation PWDebugTimerWheelTest
+
+- (PWDebugTimerWheel*) wheel
+{
+    // Few slots, so that entries wrap around the wheel.
+    return [[PWDebugTimerWheel alloc] initWithTickInterval:0.01 slotCount:8
+                                              handlerQueue:dispatch_get_global_queue (QOS_CLASS_USER_INITIATED, 0)];
+}
+
+- (void) testFiresInOrder
+{
+    PWDebugTimerWheel* wheel = self.wheel;
+    NSMutableArray<NSNumber*>* fired = [[NSMutableArray alloc] init];
+    XCTestExpectation* allFired = [self expectationWithDescription:@"all fired"];
+    allFired.expectedFulfillmentCount = 3;
+
+    for (NSNumber* iDelay in @[@0.15, @0.02, @0.05])  // 0.15 s is more than one revolution
+        [wheel scheduleAfter:iDelay.doubleValue handler:^{
+            @synchronized (fired) {
+                [fired addObject:iDelay];
+            }
+            [allFired fulfill];
+        }];
+    XCTAssertEqual (wheel.count, 3);
+
+    [self waitForExpectations:@[allFired] timeout:5.0];
+    XCTAssertEqualObjects (fired, (@[@0.02, @0.05, @0.15]));
+    XCTAssertEqual (wheel.count, 0);
+}
+
+- (void) testCancel
+{
+    PWDebugTimerWheel* wheel = self.wheel;
+    XCTestExpectation* cancelledFired = [self expectationWithDescription:@"cancelled entry fired"];
+    cancelledFired.inverted = YES;
+    XCTestExpectation* otherFired = [self expectationWithDescription:@"other entry fired"];
+
+    PWDebugTimerWheelEntry* entry = [wheel scheduleAfter:0.05 handler:^{
+        [cancelledFired fulfill];
+    }];
+    [wheel scheduleAfter:0.1 handler:^{
+        [otherFired fulfill];
+    }];
+    XCTAssertGreaterThan (entry.remainingTime, 0.0);
+
+    [wheel cancelEntry:entry];
+    XCTAssertTrue (entry.isCancelled);
+    XCTAssertEqual (entry.remainingTime, 0.0);
+    XCTAssertEqual (wheel.count, 1);
+
+    [self waitForExpectations:@[cancelledFired, otherFired] timeout:0.5];
+}
+
+@end
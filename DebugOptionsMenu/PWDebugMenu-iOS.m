@@ -32,6 +32,12 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
 @property (nonatomic, readonly) BOOL                            isControl;
 - (UIControl*)controlView;
 
+// Default is the tool tip.
+@property (nonatomic, readonly, nullable) NSString*             detailText;
+
+// Default is the control view for controls, else nil.
+@property (nonatomic, readonly, nullable) UIView*               accessoryView;
+
 @end
 
 @interface PWDebugMenuTableViewController : UITableViewController
@@ -49,6 +55,16 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
                   detailDescription:(nullable NSString*)detailDescription
                      menuController:(PWDebugMenuController*)menuController;
 
+// Scrolled to and flashed when the view appears. Used to jump to search results.
+@property (nonatomic, readwrite, strong, nullable) PWDebugOption*   highlightedOption;
+
+@end
+
+@interface PWDebugMenuSearchResultsViewController : UITableViewController <UISearchResultsUpdating>
+
+- (instancetype)initWithSearchIndex:(PWDebugOptionSearchIndex*)searchIndex
+                   selectionHandler:(void (^) (PWDebugOptionSearchResult* result))selectionHandler;
+
 @end
 
 @interface PWDebugMenuEnumOptionsViewController : PWDebugMenuTableViewController
@@ -187,6 +203,7 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
 @implementation PWDebugMenuOptionsViewController
 {
     PWDebugOptionGroup*     _optionGroup;
+    NSTimer*                _expiryTimer;   // updates the countdown of expiring options while visible
 }
 
 - (instancetype)initWithOptionGroup:(PWDebugOptionGroup*)optionGroup
@@ -204,9 +221,46 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
     return self;
 }
 
+- (void)viewDidLoad
+{
+    [super viewDidLoad];
+
+    // The root level offers a search over the whole tree.
+    if (!_optionGroup.parentGroup)
+    {
+        __weak PWDebugMenuOptionsViewController* weakSelf = self;
+        PWDebugOptionSearchIndex* searchIndex = [PWDebugOptionSearchIndex searchIndexForRootGroup:_optionGroup];
+        PWDebugMenuSearchResultsViewController* resultsController
+        = [[PWDebugMenuSearchResultsViewController alloc] initWithSearchIndex:searchIndex
+                                                             selectionHandler:^(PWDebugOptionSearchResult* result) {
+                                                                 [weakSelf showSearchResult:result];
+                                                             }];
+        UISearchController* searchController = [[UISearchController alloc] initWithSearchResultsController:resultsController];
+        searchController.searchResultsUpdater = resultsController;
+        searchController.obscuresBackgroundDuringPresentation = NO;
+        searchController.searchBar.placeholder = @"Search Options";
+        self.navigationItem.searchController = searchController;
+        self.navigationItem.hidesSearchBarWhenScrolling = NO;
+        self.definesPresentationContext = YES;
+    }
+}
+
 - (void)viewWillAppear:(BOOL)animated
 {
     [super viewWillAppear:animated];
+
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(optionDidChange:)
+                                               name:PWDebugOptionDidChangeNotification
+                                             object:nil];
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(asyncActionRunningStateDidChange:)
+                                               name:PWDebugAsyncActionOptionRunningStateDidChangeNotification
+                                             object:nil];
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(groupEnabledStateDidChange:)
+                                               name:PWDebugOptionGroupEnabledStateDidChangeNotification
+                                             object:nil];
     
     // Sort options by menu item title.
     // Note: may want to add another order criterium to debug options.
@@ -220,6 +274,132 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
     }];
 }
 
+- (void)viewDidAppear:(BOOL)animated
+{
+    [super viewDidAppear:animated];
+
+    [self scrollToHighlightedOption];
+
+    __weak PWDebugMenuOptionsViewController* weakSelf = self;
+    _expiryTimer = [NSTimer scheduledTimerWithTimeInterval:1.0 repeats:YES block:^(NSTimer* timer) {
+        [weakSelf reconfigureExpiringRows];
+    }];
+}
+
+- (void)viewWillDisappear:(BOOL)animated
+{
+    [super viewWillDisappear:animated];
+
+    [NSNotificationCenter.defaultCenter removeObserver:self
+                                                  name:PWDebugOptionDidChangeNotification
+                                                object:nil];
+    [NSNotificationCenter.defaultCenter removeObserver:self
+                                                  name:PWDebugAsyncActionOptionRunningStateDidChangeNotification
+                                                object:nil];
+    [NSNotificationCenter.defaultCenter removeObserver:self
+                                                  name:PWDebugOptionGroupEnabledStateDidChangeNotification
+                                                object:nil];
+
+    [_expiryTimer invalidate];
+    _expiryTimer = nil;
+}
+
+#pragma mark search
+
+- (void)showSearchResult:(PWDebugOptionSearchResult*)result
+{
+    PWDebugOptionGroup* group = result.group;
+    if (!group)
+        return;
+
+    self.navigationItem.searchController.active = NO;
+
+    if (group == _optionGroup)
+    {
+        self.highlightedOption = result.option;
+        [self scrollToHighlightedOption];
+    }
+    else
+    {
+        PWDebugMenuOptionsViewController* viewController;
+        viewController = [[PWDebugMenuOptionsViewController alloc] initWithOptionGroup:group
+                                                                                 title:result.path.lastObject
+                                                                     detailDescription:nil
+                                                                        menuController:self.menuController];
+        viewController.highlightedOption = result.option;
+        [self.navigationController pushViewController:viewController animated:YES];
+    }
+}
+
+- (void)scrollToHighlightedOption
+{
+    PWDebugOption* option = self.highlightedOption;
+    if (!option)
+        return;
+
+    self.highlightedOption = nil;
+    NSUInteger index = [_optionGroup.options indexOfObjectIdenticalTo:option];
+    if (index == NSNotFound)
+        return;
+
+    NSIndexPath* indexPath = [NSIndexPath indexPathForRow:index inSection:1];
+    [self.tableView selectRowAtIndexPath:indexPath animated:YES scrollPosition:UITableViewScrollPositionMiddle];
+    [self.tableView deselectRowAtIndexPath:indexPath animated:YES];
+}
+
+#pragma mark notifications
+
+- (void)optionDidChange:(NSNotification*)notification
+{
+    // Options may change on any thread.
+    PWDebugOption* option = notification.object;
+    if (NSThread.isMainThread)
+        [self reconfigureRowOfOption:option];
+    else
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self reconfigureRowOfOption:option];
+        });
+}
+
+// Updates the cell of 'option' in place, if it is visible.
+- (void)reconfigureRowOfOption:(PWDebugOption*)option
+{
+    NSUInteger index = [_optionGroup.options indexOfObjectIdenticalTo:option];
+    if (index == NSNotFound)
+        return;
+
+    NSIndexPath* indexPath = [NSIndexPath indexPathForRow:index inSection:1];
+    UITableViewCell* cell = [self.tableView cellForRowAtIndexPath:indexPath];
+    if (cell)
+        [self configureOptionCell:cell atIndexPath:indexPath];
+}
+
+- (void)reconfigureExpiringRows
+{
+    for (PWDebugOption* iOption in _optionGroup.options)
+        if (iOption.isExpiring)
+            [self reconfigureRowOfOption:iOption];
+}
+
+- (void)asyncActionRunningStateDidChange:(NSNotification*)notification
+{
+    NSUInteger index = [_optionGroup.options indexOfObjectIdenticalTo:notification.object];
+    if (index != NSNotFound)
+        [self.tableView reloadRowsAtIndexPaths:@[[NSIndexPath indexPathForRow:index inSection:1]]
+                              withRowAnimation:UITableViewRowAnimationNone];
+}
+
+- (void)groupEnabledStateDidChange:(NSNotification*)notification
+{
+    // The notification is coalesced per group change, so one pass over the visible cells is enough.
+    for (NSIndexPath* iIndexPath in self.tableView.indexPathsForVisibleRows)
+    {
+        UITableViewCell* cell = [self.tableView cellForRowAtIndexPath:iIndexPath];
+        if (cell)
+            [self configureCell:cell atIndexPath:iIndexPath];
+    }
+}
+
 #pragma mark protocol (UITableViewDataSource)
 
 - (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView
@@ -230,7 +410,7 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
 - (NSInteger)tableView:(UITableView*)tableView numberOfRowsInSection:(NSInteger)section
 {
     if (section == 0)
-        return 1;
+        return _optionGroup.parentGroup ? 2 : 1;    // sub groups show their master switch
     else
         return _optionGroup.options.count;
 }
@@ -256,6 +436,9 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
 
 - (BOOL)tableView:(UITableView *)tableView shouldHighlightRowAtIndexPath:(NSIndexPath *)indexPath
 {
+    if (indexPath.section == 0)
+        return NO;  // only switches in this section
+
     PWDebugOption* option = _optionGroup.options[indexPath.row];
     return option.isEnabled && !option.isControl;
 }
@@ -274,6 +457,7 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
     else if (option.isAction)
     {
         [option performAction:self];
+        [tableView reloadRowsAtIndexPaths:@[indexPath] withRowAnimation:UITableViewRowAnimationNone];
     }
     else if (option.isControl)
     {
@@ -292,7 +476,10 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
 {
     if (indexPath.section == 0)
     {
-        [self configureSafeOptionCell:cell];
+        if (indexPath.row == 0)
+            [self configureSafeOptionCell:cell];
+        else
+            [self configureGroupEnabledCell:cell];
     }
     else
     {
@@ -313,24 +500,47 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
     cell.accessoryView = saveStateSwitch;
 }
 
+- (void)configureGroupEnabledCell:(UITableViewCell*)cell
+{
+    cell.textLabel.text = @"Group enabled";
+    cell.detailTextLabel.text = @"Disabling a group masks all options in it and its sub groups.";
+    cell.accessoryType = UITableViewCellAccessoryNone;
+    UISwitch* enabledSwitch = [[UISwitch alloc] initWithFrame:CGRectZero];
+    {
+        enabledSwitch.on = _optionGroup.isEnabled;
+        [enabledSwitch addTarget:self action:@selector(toggleGroupEnabled:) forControlEvents:UIControlEventTouchUpInside];
+    }
+    cell.accessoryView = enabledSwitch;
+}
+
+- (IBAction)toggleGroupEnabled:(id)sender
+{
+    _optionGroup.isEnabled = !_optionGroup.isEnabled;
+
+    if ([PWDebugMenuController isSavingOptionStates])
+        [_optionGroup saveState];
+}
+
 - (void)configureOptionCell:(UITableViewCell*)cell atIndexPath:(NSIndexPath*)indexPath
 {
     PWDebugOption* option = _optionGroup.options[indexPath.row];
     NSAssert(option, nil);
     
-    UIColor* textColor = option.isEnabled ? nil : [UIColor colorWithWhite:0.5 alpha:1.0]; // a nil default color makes sure that the system apperance text color is used
+    // Options masked by a disabled group stay editable, but are shown grayed.
+    BOOL isMasked = !_optionGroup.isEffectivelyEnabled;
+    UIColor* textColor = (option.isEnabled && !isMasked) ? nil : [UIColor colorWithWhite:0.5 alpha:1.0]; // a nil default color makes sure that the system apperance text color is used
     UIColor* detailColor = [textColor colorWithAlphaComponent:0.5];
     
     cell.textLabel.text = option.title;
     cell.textLabel.numberOfLines = 0;
     cell.textLabel.lineBreakMode = NSLineBreakByWordWrapping;
     cell.textLabel.textColor = textColor;
-    cell.detailTextLabel.text = option.toolTip.length > 0 ? option.toolTip : nil;
+    cell.detailTextLabel.text = option.detailText;
     cell.detailTextLabel.numberOfLines = 0;
     cell.detailTextLabel.lineBreakMode = NSLineBreakByWordWrapping;
     cell.detailTextLabel.textColor = detailColor;
     cell.accessoryType  = option.isDetailing ? UITableViewCellAccessoryDisclosureIndicator : UITableViewCellAccessoryNone;
-    cell.accessoryView = option.isControl ? option.controlView : nil;
+    cell.accessoryView = option.accessoryView;
 }
 
 @end
@@ -357,6 +567,49 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
     return self;
 }
 
+- (void)viewWillAppear:(BOOL)animated
+{
+    [super viewWillAppear:animated];
+
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(optionDidChange:)
+                                               name:PWDebugOptionDidChangeNotification
+                                             object:_enumOption];
+}
+
+- (void)viewWillDisappear:(BOOL)animated
+{
+    [super viewWillDisappear:animated];
+
+    [NSNotificationCenter.defaultCenter removeObserver:self
+                                                  name:PWDebugOptionDidChangeNotification
+                                                object:_enumOption];
+}
+
+#pragma mark notifications
+
+- (void)optionDidChange:(NSNotification*)notification
+{
+    // Options may change on any thread.
+    if (NSThread.isMainThread)
+        [self reconfigureVisibleRows];
+    else
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self reconfigureVisibleRows];
+        });
+}
+
+// Only the check marks change, so the visible cells are updated in place.
+- (void)reconfigureVisibleRows
+{
+    for (NSIndexPath* iIndexPath in self.tableView.indexPathsForVisibleRows)
+    {
+        UITableViewCell* cell = [self.tableView cellForRowAtIndexPath:iIndexPath];
+        if (cell)
+            [self configureCell:cell atIndexPath:iIndexPath];
+    }
+}
+
 #pragma mark protocol (UITableViewDataSource)
 
 - (NSInteger)tableView:(UITableView*)tableView numberOfRowsInSection:(NSInteger)section
@@ -391,7 +644,6 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
         _enumOption.currentValue = rowValue;
         if ([PWDebugMenuController isSavingOptionStates])
             [_enumOption saveState];
-        [self.tableView reloadData];
     }
     [tableView deselectRowAtIndexPath:indexPath animated:NO];
 }
@@ -411,6 +663,71 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
 
 #pragma mark -
 
+@implementation PWDebugMenuSearchResultsViewController
+{
+    PWDebugOptionSearchIndex*               _searchIndex;
+    void (^_selectionHandler) (PWDebugOptionSearchResult* result);
+    NSArray<PWDebugOptionSearchResult*>*    _results;
+}
+
+- (instancetype)initWithSearchIndex:(PWDebugOptionSearchIndex*)searchIndex
+                   selectionHandler:(void (^) (PWDebugOptionSearchResult* result))selectionHandler
+{
+    NSParameterAssert(searchIndex);
+    NSParameterAssert(selectionHandler);
+
+    self = [super initWithStyle:UITableViewStylePlain];
+    if (self)
+    {
+        _searchIndex = searchIndex;
+        _selectionHandler = [selectionHandler copy];
+        _results = @[];
+    }
+    return self;
+}
+
+#pragma mark protocol (UISearchResultsUpdating)
+
+- (void)updateSearchResultsForSearchController:(UISearchController*)searchController
+{
+    NSString* query = searchController.searchBar.text;
+    _results = query ? [_searchIndex resultsForQuery:query] : @[];
+    [self.tableView reloadData];
+}
+
+#pragma mark protocol (UITableViewDataSource)
+
+- (NSInteger)tableView:(UITableView*)tableView numberOfRowsInSection:(NSInteger)section
+{
+    return _results.count;
+}
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath
+{
+    static NSString *CellIdentifier = @"Cell";
+    UITableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:CellIdentifier];
+    if (cell == nil)
+        cell = [[UITableViewCell alloc] initWithStyle:UITableViewCellStyleSubtitle reuseIdentifier:CellIdentifier];
+
+    PWDebugOptionSearchResult* result = _results[indexPath.row];
+    cell.textLabel.text = result.option.title;
+    cell.detailTextLabel.text = (result.path.count > 0) ? [result.path componentsJoinedByString:@" › "] : @"Debug";
+    cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
+    return cell;
+}
+
+#pragma mark protocol (UITableViewDelegate)
+
+- (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath
+{
+    [tableView deselectRowAtIndexPath:indexPath animated:NO];
+    _selectionHandler(_results[indexPath.row]);
+}
+
+@end
+
+#pragma mark -
+
 @implementation PWDebugOption (PWDebugMenuController)
 
 - (BOOL)isEnabled
@@ -450,6 +767,25 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
     return nil;
 }
 
+- (nullable NSString*)detailText
+{
+    NSString* toolTip = self.toolTip.length > 0 ? self.toolTip : nil;
+    if (!self.isExpiring)
+        return toolTip;
+
+    NSString* status;
+    if (self.remainingExpiryInterval > 0.0)
+        status = [NSString stringWithFormat:@"Reverts to default in %.0f s", ceil(self.remainingExpiryInterval)];
+    else
+        status = [NSString stringWithFormat:@"Reverts to default after %lld evaluations", (long long)self.remainingExpiryEvaluations];
+    return toolTip ? [NSString stringWithFormat:@"%@\n%@", toolTip, status] : status;
+}
+
+- (nullable UIView*)accessoryView
+{
+    return self.isControl ? self.controlView : nil;
+}
+
 @end
 
 @implementation PWDebugOptionSubGroup (PWDebugMenuController)
@@ -497,8 +833,8 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
         objc_setAssociatedObject (self, (__bridge const void*)switchControlKey, switchControl, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
         
         [switchControl addTarget:self action:@selector(toggle:) forControlEvents:UIControlEventTouchUpInside];
-        switchControl.on = (*self.target);
     }
+    switchControl.on = self.currentValue;   // may have been changed elsewhere since the last call
     return switchControl;
 }
 
@@ -557,6 +893,79 @@ NSString* const PWDebugMenuSaveStateKey = @"DebugMenuSaveState";
 
 @end
 
+@implementation PWDebugCounterOption (PWDebugMenuController)
+
+- (BOOL)isEnabled
+{
+    return YES;
+}
+
+- (BOOL)isAction
+{
+    return YES;
+}
+
+- (void)performAction:(id)sender
+{
+    [self reset];
+}
+
+- (nullable NSString*)detailText
+{
+    NSString* value = [NSString stringWithFormat:@"%lld (tap to reset)", (long long)self.value];
+    NSString* toolTip = super.detailText;
+    return toolTip ? [NSString stringWithFormat:@"%@\n%@", toolTip, value] : value;
+}
+
+@end
+
+@implementation PWDebugAsyncActionBlockOption (PWDebugMenuController)
+
+- (BOOL)isEnabled
+{
+    return YES;
+}
+
+- (BOOL)isAction
+{
+    return YES;
+}
+
+- (void)performAction:(id)sender
+{
+    // Tapping a running action cancels it instead of starting it again.
+    if (self.isRunning)
+        [self cancel];
+    else
+        [self execute:sender];
+}
+
+- (nullable NSString*)detailText
+{
+    NSString* status;
+    if (self.isRunning)
+        status = self.progress.cancelled ? @"Cancelling…" : @"Running, tap to cancel";
+    else if (self.lastExecutionDuration > 0.0)
+        status = [NSString stringWithFormat:@"Last run took %.2f s", self.lastExecutionDuration];
+    else
+        return super.detailText;
+
+    NSString* toolTip = super.detailText;
+    return toolTip ? [NSString stringWithFormat:@"%@\n%@", toolTip, status] : status;
+}
+
+- (nullable UIView*)accessoryView
+{
+    if (!self.isRunning)
+        return nil;
+
+    UIActivityIndicatorView* indicator = [[UIActivityIndicatorView alloc] initWithActivityIndicatorStyle:UIActivityIndicatorViewStyleGray];
+    [indicator startAnimating];
+    return indicator;
+}
+
+@end
+
 @implementation PWDebugActionWithNamedTargetOption (PWDebugMenuController)
 
 - (BOOL)isAction
@@ -42,6 +42,23 @@ toObservableNamed:(NSString*)observableName
         return result;
     }];
 
+    // Sub groups start with their master switch.
+    if (self.parentGroup) {
+        NSMenuItem* item = [[NSMenuItem alloc] initWithTitle:@"Enabled" action:@selector (toggleEnabled:) keyEquivalent:@""];
+        item.toolTip = @"Disabling a group masks all options in it and its sub groups.";
+        item.target  = self;
+        [menu addItem:item];
+
+        item = [[NSMenuItem alloc] initWithTitle:@"Enabled (save state)"
+                                          action:@selector (toggleEnabledAndSaveState:) keyEquivalent:@""];
+        item.keyEquivalentModifierMask = NSEventModifierFlagOption;
+        item.target = self;
+        [item setAlternate:YES];
+        [menu addItem:item];
+
+        [menu addItem:[NSMenuItem separatorItem]];
+    }
+
     for (PWDebugOption* iOptions in self.options) {
         [iOptions addMenuItemToMenu:menu];
     }
@@ -49,6 +66,23 @@ toObservableNamed:(NSString*)observableName
     return menu;
 }
 
+- (BOOL) validateMenuItem:(NSMenuItem*)menuItem
+{
+    menuItem.state = self.isEnabled ? NSControlStateValueOn : NSControlStateValueOff;
+    return YES;
+}
+
+- (void) toggleEnabled:(id)sender
+{
+    self.isEnabled = !self.isEnabled;
+}
+
+- (void) toggleEnabledAndSaveState:(id)sender
+{
+    [self toggleEnabled:sender];
+    [self saveState];
+}
+
 @end
 
 #pragma mark -
@@ -99,6 +133,19 @@ toObservableNamed:(NSString*)observableName
     return self.title;
 }
 
+// Appends the remaining time or evaluations of an expiring option to 'title'.
+- (NSString*) titleWithExpiryStatus:(NSString*)title
+{
+    NSParameterAssert (title);
+
+    if (!self.isExpiring)
+        return title;
+    if (self.remainingExpiryInterval > 0.0)
+        return [NSString stringWithFormat:@"%@ (reverts in %.0f s)", title, ceil (self.remainingExpiryInterval)];
+    return [NSString stringWithFormat:@"%@ (reverts after %lld evaluations)", title,
+            (long long)self.remainingExpiryEvaluations];
+}
+
 - (void) addMenuItemToMenu:(NSMenu*)menu
 {
     [self doesNotRecognizeSelector:_cmd];
@@ -167,6 +214,8 @@ toObservableNamed:(NSString*)observableName
 - (BOOL) validateMenuItem:(NSMenuItem*)menuItem
 {
     menuItem.state = *self.target ? NSControlStateValueOn : NSControlStateValueOff;
+    if (!menuItem.isAlternate)
+        menuItem.title = [self titleWithExpiryStatus:self.menuItemTitle];
     return YES;
 }
 
@@ -237,6 +286,13 @@ toObservableNamed:(NSString*)observableName
 - (BOOL) validateMenuItem:(NSMenuItem*)menuItem
 {
     menuItem.state = (*self.target == menuItem.tag) ? NSControlStateValueOn : NSControlStateValueOff;
+
+    // The selected value shows when it reverts.
+    NSUInteger index = [self.values indexOfObject:@(menuItem.tag)];
+    if (!menuItem.isAlternate && index != NSNotFound) {
+        NSString* title = self.titles[index];
+        menuItem.title = (menuItem.state == NSControlStateValueOn) ? [self titleWithExpiryStatus:title] : title;
+    }
     return YES;
 }
 
@@ -314,6 +370,39 @@ toObservableNamed:(NSString*)observableName
 
 #pragma mark -
 
+@implementation PWDebugCounterOption (PWDebugMenu)
+
+- (void) addMenuItemToMenu:(NSMenu*)menu
+{
+    NSParameterAssert (menu);
+
+    // Create and attach the menu item. Selecting it resets the counter.
+    NSMenuItem* item = [self createMenuItemWithAction:@selector (reset:)];
+    item.target = self;
+    item.title  = self.menuItemTitleWithValue;
+    [menu addItem:item];
+}
+
+- (NSString*) menuItemTitleWithValue
+{
+    return [NSString stringWithFormat:@"%@: %lld", self.menuItemTitle, (long long)self.value];
+}
+
+- (BOOL) validateMenuItem:(NSMenuItem*)menuItem
+{
+    menuItem.title = self.menuItemTitleWithValue;
+    return YES;
+}
+
+- (void) reset:(id)sender
+{
+    [self reset];
+}
+
+@end
+
+#pragma mark -
+
 @implementation PWDebugActionBlockOption (PWDebugMenu)
 
 - (void) addMenuItemToMenu:(NSMenu*)menu
@@ -330,6 +419,50 @@ toObservableNamed:(NSString*)observableName
 
 #pragma mark -
 
+@implementation PWDebugAsyncActionBlockOption (PWDebugMenu)
+
+- (void) addMenuItemToMenu:(NSMenu*)menu
+{
+    NSParameterAssert (menu);
+
+    // Create and attach the menu item.
+    NSMenuItem* item = [self createMenuItemWithAction:@selector (executeOrCancel:)];
+    item.target = self;
+    [menu addItem:item];
+}
+
+- (BOOL) validateMenuItem:(NSMenuItem*)menuItem
+{
+    // Show the running state in the title. Selecting a running action cancels it instead of starting it again.
+    NSProgress* progress = self.progress;
+    if (self.isRunning && progress) {
+        NSString* percentage = progress.indeterminate ? @""
+                             : [NSString stringWithFormat:@" %.0f %%", progress.fractionCompleted * 100.0];
+        menuItem.title = [NSString stringWithFormat:@"%@ (running%@, select to cancel)", self.menuItemTitle, percentage];
+        menuItem.state = NSControlStateValueMixed;
+        return !progress.cancelled;
+    }
+
+    if (self.lastExecutionDuration > 0.0)
+        menuItem.title = [NSString stringWithFormat:@"%@ (last run %.2f s)", self.menuItemTitle, self.lastExecutionDuration];
+    else
+        menuItem.title = self.menuItemTitle;
+    menuItem.state = NSControlStateValueOff;
+    return YES;
+}
+
+- (void) executeOrCancel:(id)sender
+{
+    if (self.isRunning)
+        [self cancel];
+    else
+        [self execute:sender];
+}
+
+@end
+
+#pragma mark -
+
 @implementation PWDebugActionWithNamedTargetOption (PWDebugMenu)
 
 - (void) addMenuItemToMenu:(NSMenu*)menu